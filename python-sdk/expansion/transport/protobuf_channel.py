@@ -33,3 +33,15 @@ class ProtobufChannel(ProxyChannel):
         message = self._message_type()
         message.ParseFromString(data)
         return message
+
+    # Override from ProxyChannel
+    def on_receive(self, message: Any, timestamp: Optional[int]):
+        decoded_message = self.decode(message)
+        if not decoded_message:
+            return
+        # Server may coalesce several messages into one datagram
+        batch = getattr(decoded_message, "batch", None)
+        for item in (batch or [decoded_message]):
+            if self._trace_mode:
+                self.terminal_logger.debug(f"Got: \n{item}")
+            self.terminal.on_receive(item, timestamp)
@@ -6,6 +6,7 @@
 #include <Privileged.pb.h>
 
 #include <boost/asio.hpp>
+#include <type_traits>
 
 namespace autotests { namespace client {
 
@@ -78,8 +79,17 @@ protected:
     FrameT receivedMessage;
     if (receivedMessage.ParseFromArray(pData, int(nTotal))) {
       ITerminalPtr<FrameT> pTerminal = m_pTerminalLink.lock();
-      if (pTerminal)
-        pTerminal->onMessageReceived(std::move(receivedMessage));
+      if (!pTerminal)
+        return;
+      if constexpr (std::is_same_v<FrameT, spex::Message>) {
+        // Server may coalesce several messages into one datagram
+        if (receivedMessage.batch_size()) {
+          for (spex::Message& message: *receivedMessage.mutable_batch())
+            pTerminal->onMessageReceived(std::move(message));
+          return;
+        }
+      }
+      pTerminal->onMessageReceived(std::move(receivedMessage));
     }
   }
 
@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <Conveyor/Conveyor.h>
+
+namespace autotests {
+
+// A logic, that on every stage increments each of it's counters exactly once.
+// Work is distributed between threads in the same way as real logics do it.
+class CountingLogic : public conveyor::IAbstractLogic
+{
+public:
+  CountingLogic(std::atomic<uint32_t>& sequence,
+                uint16_t nTotalStages, size_t nTotalCounters,
+                conveyor::DataAccess access)
+    : m_sequence(sequence),
+      m_nTotalStages(nTotalStages),
+      m_counters(nTotalCounters),
+      m_access(access)
+  {}
+
+  uint16_t getStagesCount() override { return m_nTotalStages; }
+
+  bool prephare(uint16_t nStageId, uint32_t, uint64_t) override
+  {
+    if (nStageId == 0) {
+      m_nStartedAt = m_sequence.fetch_add(1);
+    }
+    m_nNextCounter.store(0);
+    return true;
+  }
+
+  void proceed(uint16_t nStageId, uint32_t, uint64_t) override
+  {
+    size_t nId = m_nNextCounter.fetch_add(1);
+    for (; nId < m_counters.size(); nId = m_nNextCounter.fetch_add(1)) {
+      m_counters[nId].fetch_add(1);
+    }
+    if (nStageId + 1 == m_nTotalStages) {
+      m_nFinishedAt.store(m_sequence.fetch_add(1));
+    }
+  }
+
+  size_t getCooldownTimeUs() const override { return 0; }
+  conveyor::DataAccess getDataAccess() const override { return m_access; }
+
+  bool allCountersAre(uint32_t nExpectedValue) const
+  {
+    for (std::atomic<uint32_t> const& counter : m_counters) {
+      if (counter.load() != nExpectedValue) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  uint32_t startedAt()  const { return m_nStartedAt; }
+  uint32_t finishedAt() const { return m_nFinishedAt.load(); }
+
+private:
+  std::atomic<uint32_t>&             m_sequence;
+  uint16_t                           m_nTotalStages;
+  std::vector<std::atomic<uint32_t>> m_counters;
+  std::atomic<size_t>                m_nNextCounter;
+  uint32_t                           m_nStartedAt  = 0;
+  std::atomic<uint32_t>              m_nFinishedAt = 0;
+  conveyor::DataAccess               m_access;
+};
+
+using CountingLogicPtr = std::shared_ptr<CountingLogic>;
+
+
+class ConveyorTests : public ::testing::TestWithParam<conveyor::Conveyor::Mode>
+{
+protected:
+  void run(uint16_t nTotalThreads, uint32_t nTotalTicks)
+  {
+    std::vector<std::thread> slaves;
+    for (uint16_t i = 1; i < nTotalThreads; ++i) {
+      slaves.emplace_back([this]() { m_pConveyor->joinAsSlave(); });
+    }
+    for (uint32_t i = 0; i < nTotalTicks; ++i) {
+      m_pConveyor->proceed(1000);
+    }
+    m_pConveyor->stop();
+    for (std::thread& slave : slaves) {
+      slave.join();
+    }
+  }
+
+  CountingLogicPtr makeLogic(uint16_t nTotalStages, size_t nTotalCounters,
+                             conveyor::DataAccess access = {})
+  {
+    return std::make_shared<CountingLogic>(
+          m_sequence, nTotalStages, nTotalCounters, access);
+  }
+
+protected:
+  std::unique_ptr<conveyor::Conveyor> m_pConveyor;
+  std::atomic<uint32_t>               m_sequence = 0;
+};
+
+
+TEST_P(ConveyorTests, AllStagesAreProceeded)
+{
+  const uint16_t nTotalThreads = 4;
+  const uint32_t nTotalTicks   = 10;
+  m_pConveyor = std::make_unique<conveyor::Conveyor>(nTotalThreads, GetParam());
+
+  std::vector<CountingLogicPtr> logics;
+  for (uint16_t nStages = 1; nStages < 6; ++nStages) {
+    // Logics, that read physics, may be proceeded concurrently
+    const conveyor::DataAccess access = (nStages % 2)
+        ? conveyor::DataAccess(conveyor::eNoData, conveyor::ePhysics)
+        : conveyor::DataAccess(conveyor::ePhysics, conveyor::eNoData);
+    logics.push_back(makeLogic(nStages, 1000, access));
+    m_pConveyor->addLogicToChain(logics.back());
+  }
+
+  run(nTotalThreads, nTotalTicks);
+
+  for (size_t i = 0; i < logics.size(); ++i) {
+    const uint32_t nStages = static_cast<uint32_t>(i + 1);
+    EXPECT_TRUE(logics[i]->allCountersAre(nTotalTicks * nStages));
+  }
+}
+
+TEST_P(ConveyorTests, DependentLogicsAreOrdered)
+{
+  const uint16_t nTotalThreads = 4;
+  m_pConveyor = std::make_unique<conveyor::Conveyor>(nTotalThreads, GetParam());
+
+  // Logics 'a1' and 'a2' are independent, but 'b' depends on both of them
+  CountingLogicPtr a1 = makeLogic(
+        2, 5000, conveyor::DataAccess(conveyor::eNoData, conveyor::ePhysics));
+  CountingLogicPtr a2 = makeLogic(
+        3, 5000, conveyor::DataAccess(conveyor::eNoData, conveyor::eResources));
+  CountingLogicPtr b  = makeLogic(
+        2, 5000, conveyor::DataAccess(conveyor::ePhysics | conveyor::eResources,
+                                      conveyor::eNoData));
+  m_pConveyor->addLogicToChain(a1);
+  m_pConveyor->addLogicToChain(a2);
+  m_pConveyor->addLogicToChain(b);
+
+  run(nTotalThreads, 1);
+
+  EXPECT_TRUE(a1->allCountersAre(2));
+  EXPECT_TRUE(a2->allCountersAre(3));
+  EXPECT_TRUE(b->allCountersAre(2));
+  EXPECT_LT(a1->finishedAt(), b->startedAt());
+  EXPECT_LT(a2->finishedAt(), b->startedAt());
+}
+
+TEST(ConveyorDataAccessTests, Conflicts)
+{
+  using conveyor::DataAccess;
+  const DataAccess readsPhysics(conveyor::ePhysics, conveyor::eNoData);
+  const DataAccess writesPhysics(conveyor::eNoData, conveyor::ePhysics);
+  const DataAccess writesPlayers(conveyor::eNoData, conveyor::ePlayers);
+  const DataAccess everything;
+
+  EXPECT_FALSE(readsPhysics.conflictsWith(readsPhysics));
+  EXPECT_FALSE(writesPhysics.conflictsWith(writesPlayers));
+  EXPECT_TRUE(readsPhysics.conflictsWith(writesPhysics));
+  EXPECT_TRUE(writesPhysics.conflictsWith(readsPhysics));
+  EXPECT_TRUE(writesPhysics.conflictsWith(writesPhysics));
+  EXPECT_TRUE(everything.conflictsWith(readsPhysics));
+  EXPECT_TRUE(readsPhysics.conflictsWith(everything));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    AllModes, ConveyorTests,
+    ::testing::Values(conveyor::Conveyor::Mode::eLockstep,
+                      conveyor::Conveyor::Mode::eWorkStealing));
+
+} // namespace autotests
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <set>
+#include <vector>
+
+#include <ConveyorTools/PhysicalObjectsFilters.h>
+#include <Autotests/TestUtils/RandomObjectsFixture.h>
+
+namespace autotests {
+
+class PhysicalObjectsFiltersTests : public RandomObjectsFixture
+{
+protected:
+  void SetUp() override
+  {
+    RandomObjectsFixture::SetUp();
+    spawnObjects(7, 30000, 1, 200);
+  }
+
+  using Filtered = std::set<newton::PhysicalObject const*>;
+
+  Filtered proceed(tools::PysicalObjectsFilter& filter, bool lUseGrid)
+  {
+    world::Grid::setGlobal(lUseGrid ? &m_grid : nullptr);
+    filter.attachToContainer(
+          std::make_shared<utils::ObjectsContainer<newton::PhysicalObject>>());
+    filter.prephare();
+    filter.proceed();
+
+    // Only objects of this test are taken into account
+    Filtered filtered;
+    for (newton::PhysicalObject const* pObject: filter.getFiltered()) {
+      for (auto const& pOwnObject: m_objects) {
+        if (pOwnObject.get() == pObject) {
+          filtered.insert(pObject);
+        }
+      }
+    }
+    return filtered;
+  }
+
+  Filtered expected(std::function<bool(newton::PhysicalObject const&)> fCheck)
+  {
+    Filtered filtered;
+    for (auto const& pObject: m_objects) {
+      if (fCheck(*pObject)) {
+        filtered.insert(pObject.get());
+      }
+    }
+    return filtered;
+  }
+};
+
+TEST_F(PhysicalObjectsFiltersTests, RectangleFilter)
+{
+  // Rectangle inside of the core, on it's border and outside of the core
+  for (geometry::Point center: {geometry::Point(0, 0),
+                                geometry::Point(10000, -3000),
+                                geometry::Point(-20000, 25000)}) {
+    const geometry::Rectangle rect(center, 5000, 3000);
+    tools::RectangeFilter filter(rect);
+
+    const Filtered filtered = expected([&rect](auto const& object) {
+      return rect.isCoveredByCircle(object.getPosition(), object.getRadius());
+    });
+    ASSERT_FALSE(filtered.empty());
+    EXPECT_EQ(filtered, proceed(filter, true));
+    EXPECT_EQ(filtered, proceed(filter, false));
+  }
+}
+
+TEST_F(PhysicalObjectsFiltersTests, CircleAndRingFilters)
+{
+  const geometry::Point center(2500, -7000);
+  const double innerRadius = 1500;
+  const double outerRadius = 4000;
+
+  tools::CircleFilter circle(center, outerRadius);
+  const Filtered inCircle = expected([&](auto const& object) {
+    return center.distance(object.getPosition())
+        < outerRadius + object.getRadius();
+  });
+  ASSERT_FALSE(inCircle.empty());
+  EXPECT_EQ(inCircle, proceed(circle, true));
+  EXPECT_EQ(inCircle, proceed(circle, false));
+
+  tools::RingFilter ring(center, innerRadius, outerRadius);
+  const Filtered inRing = expected([&](auto const& object) {
+    const double distance = center.distance(object.getPosition());
+    return distance + object.getRadius() >= innerRadius
+        && distance - object.getRadius() < outerRadius;
+  });
+  ASSERT_FALSE(inRing.empty());
+  ASSERT_LT(inRing.size(), inCircle.size());
+  EXPECT_EQ(inRing, proceed(ring, true));
+  EXPECT_EQ(inRing, proceed(ring, false));
+}
+
+} // namespace autotests
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <set>
+#include <vector>
+
+#include <ConveyorTools/SpatialQueryEngine.h>
+#include <Newton/PhysicsStorage.h>
+#include <Utils/Randomizer.h>
+#include <Autotests/TestUtils/RandomObjectsFixture.h>
+
+namespace autotests {
+
+class SpatialQueryEngineTests : public RandomObjectsFixture
+{
+protected:
+  void SetUp() override
+  {
+    RandomObjectsFixture::SetUp();
+    world::Grid::setGlobal(&m_grid);
+    spawnObjects(11, 15000, 10, 10);
+  }
+
+  void proceed()
+  {
+    // The engine is proceeded in one thread, the same way as conveyor does it
+    for (uint16_t nStageId = 0; nStageId < m_engine.getStagesCount();
+         ++nStageId) {
+      if (m_engine.prephare(nStageId, 0, 0)) {
+        m_engine.proceed(nStageId, 0, 0);
+      }
+    }
+  }
+
+  std::set<uint32_t> expected(uint32_t nCenterId, double radius) const
+  {
+    const geometry::Point center =
+        newton::PhysicsStorage::instance().getPosition(nCenterId);
+    std::set<uint32_t> found;
+    for (auto const& pObject: m_objects) {
+      if (center.distanceSqr(pObject->getPosition()) < radius * radius) {
+        found.insert(pObject->getInstanceId());
+      }
+    }
+    return found;
+  }
+
+protected:
+  tools::SpatialQueryEngine m_engine;
+};
+
+TEST_F(SpatialQueryEngineTests, QueriesAreAnsweredInOnePass)
+{
+  // Clock is not set, so 'now' is always 0
+  struct Request {
+    tools::SpatialQueryPtr pQuery;
+    uint32_t               nCenterId;
+    double                 radius;
+  };
+  std::vector<Request> requests;
+  for (size_t i = 0; i < 32; ++i) {
+    const uint32_t nCenterId =
+        m_objects[utils::Randomizer::yield<size_t>(0, m_objects.size() - 1)]
+        ->getInstanceId();
+    const double radius = utils::Randomizer::yield<double>(500, 5000);
+
+    tools::SpatialQueryPtr pQuery = std::make_shared<tools::SpatialQuery>();
+    pQuery->requestAt(0, nCenterId, radius);
+    m_engine.registerQuery(pQuery);
+    requests.push_back(Request{pQuery, nCenterId, radius});
+  }
+
+  // This query should be dropped by the engine
+  tools::SpatialQueryPtr pDropped = std::make_shared<tools::SpatialQuery>();
+  pDropped->requestAt(0, m_objects.front()->getInstanceId(), 1000);
+  m_engine.registerQuery(pDropped);
+  pDropped.reset();
+
+  // This query is not due yet
+  tools::SpatialQueryPtr pDelayed = std::make_shared<tools::SpatialQuery>();
+  pDelayed->requestAt(1000, m_objects.front()->getInstanceId(), 1000);
+  m_engine.registerQuery(pDelayed);
+
+  proceed();
+
+  for (Request const& request: requests) {
+    ASSERT_TRUE(request.pQuery->isReady());
+    std::vector<uint32_t> const& results = request.pQuery->getResults();
+    const std::set<uint32_t> found(results.begin(), results.end());
+    // Every object should be found once
+    EXPECT_EQ(results.size(), found.size());
+    EXPECT_EQ(expected(request.nCenterId, request.radius), found);
+
+    // Results are grouped by cells
+    const newton::PhysicsStorage& storage = newton::PhysicsStorage::instance();
+    size_t nTotalInCells = 0;
+    for (auto const& cellHits: request.pQuery->getCells()) {
+      EXPECT_EQ(cellHits.pCell->getVersion(), cellHits.nVersion);
+      for (uint32_t i = cellHits.nBegin; i < cellHits.nEnd; ++i) {
+        const geometry::Point position = storage.getPosition(results[i]);
+        EXPECT_TRUE(cellHits.pCell->contains(position.x, position.y));
+      }
+      if (cellHits.lCovered) {
+        // All objects of the covered cell are found
+        EXPECT_EQ(cellHits.pCell->getObjects().size(),
+                  cellHits.nEnd - cellHits.nBegin);
+      }
+      nTotalInCells += cellHits.nEnd - cellHits.nBegin;
+    }
+    EXPECT_EQ(results.size(), nTotalInCells);
+  }
+  EXPECT_FALSE(pDelayed->isReady());
+}
+
+} // namespace autotests
@@ -152,6 +152,13 @@ TEST_F(CelestialScannerTests, ScanAsteroidsNearby)
     for(auto asteroid : asteroids)
       EXPECT_LE(shipPosition.distance(asteroid.position), nScanRadiusKm * 1000);
 
+    // Nearest asteroids are reported first (asteroids may move a bit, while
+    // results are being sent)
+    for (size_t i = 1; i < asteroids.size(); ++i) {
+      EXPECT_LE(shipPosition.distance(asteroids[i - 1].position),
+                shipPosition.distance(asteroids[i].position) + 10);
+    }
+
     if (nScanRadiusKm == 31) {
       EXPECT_EQ(101, asteroids.size());
     }
@@ -67,6 +67,16 @@ protected:
   }
 };
 
+class ExploringShipsWithCoalescingTests : public ExploringShipsFunctionalTests
+{
+protected:
+  // overrides from FunctionalTestFixture interface
+  config::ApplicationCfg prephareConfiguration() override {
+    return ExploringShipsFunctionalTests::prephareConfiguration()
+        .setMessagesCoalescing(true);
+  }
+};
+
 TEST_F(ExploringShipsFunctionalTests, GetShipsCount)
 {
   ASSERT_TRUE(
@@ -103,4 +113,21 @@ TEST_F(ExploringShipsFunctionalTests, GetShipsTypes)
   }
 }
 
+TEST_F(ExploringShipsWithCoalescingTests, GetShipsCount)
+{
+  // Server sends information about every ship in a separate message, but
+  // they should be coalesced into one datagram
+  ASSERT_TRUE(
+        Scenarios::Login()
+        .sendLoginRequest("admin", "admin")
+        .expectSuccess());
+  client::ClientCommutatorPtr pCommutator = openCommutatorSession();
+  ASSERT_TRUE(pCommutator);
+
+  client::ModulesList shipsInfo;
+  ASSERT_TRUE(client::GetAllModules(*pCommutator, "Ship", shipsInfo));
+
+  EXPECT_EQ(5, shipsInfo.size());
+}
+
 } // namespace autotests
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <Network/Interfaces.h>
+
+namespace autotests
+{
+
+// Just stores all sent datagrams
+class MockedBinaryChannel : public network::IBinaryChannel
+{
+public:
+  struct Datagram {
+    uint32_t    nSessionId;
+    std::string data;
+  };
+
+  bool send(uint32_t nSessionId, network::BinaryMessage&& frame) override
+  {
+    m_sent.push_back(Datagram{
+      nSessionId,
+      std::string(reinterpret_cast<char const*>(frame.m_pBody),
+                  frame.m_nLength)});
+    return true;
+  }
+  void closeSession(uint32_t) override {}
+  bool isValid() const override { return true; }
+  void attachToTerminal(network::IBinaryTerminalPtr) override {}
+  void detachFromTerminal() override {}
+
+  std::vector<Datagram> m_sent;
+};
+
+using MockedBinaryChannelPtr = std::shared_ptr<MockedBinaryChannel>;
+
+} // namespace autotests
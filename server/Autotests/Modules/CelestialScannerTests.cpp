@@ -0,0 +1,270 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+
+#include <Utils/Randomizer.h>
+#include <World/Player.h>
+#include <Modules/Managers.h>
+#include <Modules/CelestialScanner/CelestialScanner.h>
+#include <Modules/Ship/Ship.h>
+#include <World/CelestialBodies/Asteroid.h>
+#include <Autotests/ClientSDK/Modules/ClientCommutator.h>
+#include <Autotests/ClientSDK/Modules/ClientCelestialScanner.h>
+#include <Autotests/Modules/ModulesTestFixture.h>
+#include <Autotests/Modules/Helper.h>
+
+namespace autotests {
+
+using ClientCelestialScannerPtr = std::shared_ptr<client::CelestialScanner>;
+
+// Unlike functional CelestialScannerTests, these tests look at the module's
+// reports tick by tick
+class CelestialScannerModuleTests : public ModulesTestFixture
+{
+public:
+  CelestialScannerModuleTests()
+    : m_nMaxRadiusKm(1000)
+    , m_nProcessingTimeUs(1)
+    , m_nScannerSlot(modules::Commutator::invalidSlot())
+  {}
+
+  void SetUp() override;
+
+  client::ClientCommutatorPtr shipCommutator();
+  ClientCelestialScannerPtr   spawnScanner();
+
+protected:
+  struct TickReports {
+    size_t   nTotalBytes      = 0;
+    size_t   nMaxReportBytes  = 0;
+    size_t   nTotalAsteroids  = 0;
+    uint32_t nLeft            = std::numeric_limits<uint32_t>::max();
+      // 'left' of the last report
+    bool     lScannerBusy     = false;
+  };
+
+  void spawnAsteroids(size_t nTotal, double radius);
+    // Spawn 'nTotal' asteroids around the ship, not further than 'radius'
+
+  bool sendScanRequest(ClientCelestialScannerPtr pScanner);
+
+  TickReports proceedTick(ClientCelestialScannerPtr pScanner);
+    // Proceed the environment for a single tick and pick all messages, that
+    // have been sent by the scanner during this tick. Every report's 'left'
+    // should be less than the previous one's.
+
+protected:
+  uint32_t m_nMaxRadiusKm;
+  uint32_t m_nProcessingTimeUs;
+  uint32_t m_nShipSlot;
+  uint32_t m_nScannerSlot;
+
+  modules::CelestialScannerManagerPtr m_pCelestialScannerManager;
+
+  client::RootSessionPtr           m_pRootSession;
+  client::ClientCommutatorPtr      m_pRootCommutator;
+  modules::ShipPtr                 m_pShip;
+  modules::CelestialScannerPtr     m_pCelestialScanner;
+  std::vector<world::AsteroidUptr> m_asteroids;
+  uint32_t m_nLastLeft = std::numeric_limits<uint32_t>::max();
+    // 'left' of the last report, that has been received by 'proceedTick()'
+};
+
+void CelestialScannerModuleTests::SetUp()
+{
+  ModulesTestFixture::SetUp();
+
+  m_pCelestialScannerManager =
+      std::make_shared<modules::CelestialScannerManager>();
+  m_conveyor.addLogicToChain(m_pCelestialScannerManager);
+
+  // Create a ship with a celestial scanner on it
+  m_pShip = std::make_shared<modules::Ship>(
+        "Scout", "scout-1", m_pPlayer, 1000, 10);
+  m_nShipSlot = m_pPlayer->onNewShip(m_pShip);
+
+  m_pCelestialScanner = std::make_shared<modules::CelestialScanner>(
+        "CelestialScanner_1", m_pPlayer, m_nMaxRadiusKm, m_nProcessingTimeUs);
+  m_nScannerSlot = m_pShip->installModule(m_pCelestialScanner);
+  ASSERT_NE(modules::Commutator::invalidSlot(), m_nScannerSlot);
+
+  m_pRootSession = Helper::connect(*this, 5);
+  ASSERT_TRUE(m_pRootSession);
+}
+
+client::ClientCommutatorPtr CelestialScannerModuleTests::shipCommutator()
+{
+  if (!m_pRootCommutator) {
+    m_pRootCommutator = Helper::openCommutatorSession(*this, m_pRootSession);
+    EXPECT_TRUE(m_pRootCommutator);
+    if (!m_pRootCommutator) {
+      return nullptr;
+    }
+  }
+
+  client::Router::SessionPtr pTunnel =
+      m_pRootCommutator->openSession(m_nShipSlot);
+  if (!pTunnel) {
+    return client::ClientCommutatorPtr();
+  }
+
+  client::ClientCommutatorPtr pCommutator =
+      std::make_shared<client::ClientCommutator>(m_pRouter);
+  pCommutator->attachToChannel(pTunnel);
+  return pCommutator;
+}
+
+ClientCelestialScannerPtr CelestialScannerModuleTests::spawnScanner()
+{
+  client::ClientCommutatorPtr pCommutator = shipCommutator();
+
+  client::Router::SessionPtr pTunnel =
+      pCommutator->openSession(m_nScannerSlot);
+  if (!pTunnel) {
+    return ClientCelestialScannerPtr();
+  }
+
+  ClientCelestialScannerPtr pScanner =
+      std::make_shared<client::CelestialScanner>();
+  pScanner->attachToChannel(pTunnel);
+  return pScanner;
+}
+
+void CelestialScannerModuleTests::spawnAsteroids(size_t nTotal, double radius)
+{
+  for (size_t i = 0; i < nTotal; ++i) {
+    world::AsteroidUptr pAsteroid = std::make_unique<world::Asteroid>(
+          utils::Randomizer::yield<double>(10, 100),
+          world::ResourcesArray().metals(1).silicates(1).ice(1).stones(10),
+          static_cast<uint32_t>(m_asteroids.size() + 1));
+    geometry::Point position;
+    utils::Randomizer::yield(position, m_pShip->getPosition(), radius);
+    pAsteroid->moveTo(position);
+    m_asteroids.push_back(std::move(pAsteroid));
+  }
+}
+
+bool CelestialScannerModuleTests::sendScanRequest(
+    ClientCelestialScannerPtr pScanner)
+{
+  spex::Message request;
+  spex::ICelestialScanner::Scan* pBody =
+      request.mutable_celestial_scanner()->mutable_scan();
+  pBody->set_scanning_radius_km(m_nMaxRadiusKm);
+  pBody->set_minimal_radius_m(5);
+  return pScanner->send(std::move(request));
+}
+
+CelestialScannerModuleTests::TickReports
+CelestialScannerModuleTests::proceedTick(ClientCelestialScannerPtr pScanner)
+{
+  proceedEnviroment();
+
+  TickReports reports;
+  spex::Message message;
+  while (pScanner->getChannel()->pickAny(message)) {
+    EXPECT_EQ(spex::Message::kCelestialScanner, message.choice_case());
+    spex::ICelestialScanner const& body = message.celestial_scanner();
+    if (body.choice_case() == spex::ICelestialScanner::kScanningFailed) {
+      EXPECT_EQ(spex::ICelestialScanner::SCANNER_BUSY, body.scanning_failed());
+      reports.lScannerBusy = true;
+      continue;
+    }
+    EXPECT_EQ(spex::ICelestialScanner::kScanningReport, body.choice_case());
+    EXPECT_LT(body.scanning_report().left(), m_nLastLeft);
+    m_nLastLeft = body.scanning_report().left();
+
+    // Scanner measures the report before it is put into a tunnel
+    spex::Message report;
+    *report.mutable_celestial_scanner() = body;
+    const size_t nReportBytes = report.ByteSizeLong();
+    reports.nTotalBytes    += nReportBytes;
+    reports.nMaxReportBytes = std::max(reports.nMaxReportBytes, nReportBytes);
+    reports.nTotalAsteroids +=
+        static_cast<size_t>(body.scanning_report().asteroids_size());
+    reports.nLeft = m_nLastLeft;
+  }
+  return reports;
+}
+
+TEST_F(CelestialScannerModuleTests, ReportIsStreamedByTicks)
+{
+  utils::Randomizer::setPattern(42);
+  // About 50 bytes per asteroid, so the report is several times larger, than
+  // 'nReportBytesPerTick'
+  const size_t nTotalAsteroids = 2000;
+  spawnAsteroids(nTotalAsteroids, 500000);
+
+  ClientCelestialScannerPtr pScanner = spawnScanner();
+  ASSERT_TRUE(pScanner);
+  ASSERT_TRUE(sendScanRequest(pScanner));
+
+  size_t nReportingTicks = 0;
+  size_t nReported       = 0;
+  bool   lBusyRequested  = false;
+  bool   lBusyReceived   = false;
+  for (size_t i = 0; i < 1000 && m_nLastLeft; ++i) {
+    TickReports reports = proceedTick(pScanner);
+    lBusyReceived |= reports.lScannerBusy;
+    if (!reports.nTotalBytes) {
+      continue;
+    }
+    ++nReportingTicks;
+    nReported += reports.nTotalAsteroids;
+    // The last report of the tick may exceed the limit
+    EXPECT_LE(reports.nTotalBytes,
+              modules::CelestialScanner::nReportBytesPerTick +
+              reports.nMaxReportBytes);
+
+    if (reports.nLeft && !lBusyRequested) {
+      // Scanner is still streaming the report, so it can't scan again
+      ASSERT_TRUE(sendScanRequest(pScanner));
+      lBusyRequested = true;
+    }
+  }
+  EXPECT_EQ(0, m_nLastLeft);
+  EXPECT_LT(1, nReportingTicks);
+  EXPECT_EQ(nTotalAsteroids, nReported);
+  EXPECT_TRUE(lBusyRequested);
+  EXPECT_TRUE(lBusyReceived);
+
+  // Scanner becomes idle, once the whole report has been sent
+  justWait(20);
+  EXPECT_TRUE(m_pCelestialScanner->isIdle());
+}
+
+TEST_F(CelestialScannerModuleTests, SessionClosedWhileStreaming)
+{
+  utils::Randomizer::setPattern(43);
+  spawnAsteroids(2000, 500000);
+
+  ClientCelestialScannerPtr pScanner = spawnScanner();
+  ASSERT_TRUE(pScanner);
+  ASSERT_TRUE(sendScanRequest(pScanner));
+
+  TickReports reports;
+  for (size_t i = 0; i < 1000 && !reports.nTotalBytes; ++i) {
+    reports = proceedTick(pScanner);
+  }
+  ASSERT_LT(0, reports.nTotalBytes);
+  ASSERT_LT(0, reports.nLeft);
+  ASSERT_FALSE(m_pCelestialScanner->isIdle());
+
+  // Client closes the session in the middle of the report
+  spex::Message request;
+  request.mutable_session()->set_close(true);
+  ASSERT_TRUE(pScanner->send(std::move(request)));
+  justWait(20);
+  EXPECT_TRUE(m_pCelestialScanner->isIdle());
+
+  // The rest of the report is not sent, so another session may scan
+  ClientCelestialScannerPtr pOtherScanner = spawnScanner();
+  ASSERT_TRUE(pOtherScanner);
+  ASSERT_TRUE(sendScanRequest(pOtherScanner));
+  spex::ICelestialScanner response;
+  ASSERT_TRUE(pOtherScanner->wait(response, 1000));
+  EXPECT_EQ(spex::ICelestialScanner::kScanningReport, response.choice_case());
+}
+
+} // namespace autotests
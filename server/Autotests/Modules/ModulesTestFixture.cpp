@@ -27,6 +27,7 @@ void ModulesTestFixture::SetUp()
 
   m_pNewtonEngine = std::make_shared<FreezableLogic>(
                                       std::make_shared<newton::NewtonEngine>());
+  m_pSpatialQueryEngine    = std::make_shared<tools::SpatialQueryEngine>();
   m_pCommutatorManager     = std::make_shared<modules::CommutatorManager>();
   m_pEngineManager         = std::make_shared<modules::EngineManager>();
   m_pPassiveScannerManager = std::make_shared<modules::PassiveScannerManager>();
@@ -36,8 +37,11 @@ void ModulesTestFixture::SetUp()
   m_conveyor.addLogicToChain(m_pNewtonEngine);
   m_conveyor.addLogicToChain(m_pCommutatorManager);
   m_conveyor.addLogicToChain(m_pEngineManager);
+  m_conveyor.addLogicToChain(m_pSpatialQueryEngine);
   m_conveyor.addLogicToChain(m_pPassiveScannerManager);
 
+  tools::SpatialQueryEngine::setGlobal(m_pSpatialQueryEngine.get());
+
   m_fConveyorProceeder = [this]() { this->proceedEnviroment(); };
 
   // Components on server
@@ -15,6 +15,7 @@
 #include <Autotests/TestUtils/Connector.h>
 #include <Utils/Linker.h>
 #include <Modules/Managers.h>
+#include <ConveyorTools/SpatialQueryEngine.h>
 
 namespace autotests {
 
@@ -29,6 +30,7 @@ public:
 
   void TearDown() override {
     world::Grid::setGlobal(nullptr);
+    tools::SpatialQueryEngine::setGlobal(nullptr);
     utils::GlobalClock::reset();
   }
 
@@ -62,6 +64,7 @@ protected:
 
   // Managers
   FreezableLogicPtr                 m_pNewtonEngine;
+  tools::SpatialQueryEnginePtr      m_pSpatialQueryEngine;
   modules::CommutatorManagerPtr     m_pCommutatorManager;
   modules::EngineManagerPtr         m_pEngineManager;
   modules::PassiveScannerManagerPtr m_pPassiveScannerManager;
@@ -114,6 +114,10 @@ protected:
       UpdatesJournal& journal,
       client::ClientPassiveScannerPtr pScanner);
 
+  modules::PassiveScanner::GlobalScanStats waitGlobalScan();
+    // Proceed until the next global scan is done and return statistics of
+    // that scan
+
 protected:
   // Scanner params
   std::string m_sScannerName;
@@ -223,6 +227,22 @@ void PassiveScannerTests::pickAllUpdates(
   }
 }
 
+modules::PassiveScanner::GlobalScanStats PassiveScannerTests::waitGlobalScan()
+{
+  const modules::PassiveScanner::GlobalScanStats before =
+      m_pPassiveScanner->getGlobalScanStats();
+  while (m_pPassiveScanner->getGlobalScanStats().nTotalScans ==
+         before.nTotalScans) {
+    proceedEnviroment();
+  }
+  modules::PassiveScanner::GlobalScanStats stats =
+      m_pPassiveScanner->getGlobalScanStats();
+  stats.nTotalScans   -= before.nTotalScans;
+  stats.nCellsChecked -= before.nCellsChecked;
+  stats.nCellsSkipped -= before.nCellsSkipped;
+  return stats;
+}
+
 struct Tool {
   // Number of helpers to authoring tests
 
@@ -325,6 +345,11 @@ TEST_F(PassiveScannerTests, ScanMultipleObjects)
   for (size_t i = 0; i < 200; ++i) {
     ships.push_back(Tool::spawnShip(grid.asRect(), pOtherPlayer));
   }
+  // Ships of the same player should not be reported
+  std::vector<modules::ShipPtr> ownShips;
+  for (size_t i = 0; i < 50; ++i) {
+    ownShips.push_back(Tool::spawnShip(grid.asRect(), m_pPlayer));
+  }
 
   for (uint32_t i = 0; i < 50; ++i) {
     // Move ship to random position
@@ -489,4 +514,91 @@ TEST_F(PassiveScannerTests, MultipleSessions)
   }
 }
 
+TEST_F(PassiveScannerTests, SkipUnchangedCoveredCells)
+{
+  utils::Randomizer::setPattern(911);
+  ASSERT_TRUE(tools::SpatialQueryEngine::getGlobal());
+
+  const uint32_t nScanningRadius = m_nRadiusKm * 1000;
+  // Scanning radius covers 5 cells, Grid has 25 * 25 size
+  world::Grid grid(25, nScanningRadius / 5);
+  world::Grid::setGlobal(&grid);
+
+  // All asteroids are in cells, that are completely covered by the scanning
+  // radius
+  std::vector<world::Asteroid::Uptr> asteroids;
+  std::set<const world::Cell*>       cells;
+  for (size_t i = 0; i < 20; ++i) {
+    asteroids.push_back(
+          Tool::spawnAsteroid(m_pShip->getPosition(), nScanningRadius * 0.5));
+    const geometry::Point& position = asteroids.back()->getPosition();
+    cells.insert(grid.getCell(position.x, position.y));
+  }
+  // The ship itself is also found in it's cell
+  cells.insert(grid.getCell(m_pShip->getPosition().x,
+                            m_pShip->getPosition().y));
+
+  client::ClientPassiveScannerPtr pScanner = spawnScanner();
+  ASSERT_TRUE(pScanner);
+  ASSERT_TRUE(pScanner->sendMonitor());
+  ASSERT_TRUE(pScanner->waitMonitorAck());
+
+  // The first scans remember covered cells
+  waitGlobalScan();
+  waitGlobalScan();
+
+  // Nothing has been changed, so all cells are skipped
+  modules::PassiveScanner::GlobalScanStats stats = waitGlobalScan();
+  EXPECT_EQ(0, stats.nCellsChecked);
+  EXPECT_EQ(cells.size(), stats.nCellsSkipped);
+
+  UpdatesJournal journal;
+  pickAllUpdates(journal, pScanner);
+  ASSERT_EQ(asteroids.size(), journal.allAsteroidsIds().size());
+
+  // A new asteroid enters one of covered cells
+  const world::Cell*    pCell     = *cells.begin();
+  const double          halfWidth = pCell->width() / 2.0;
+  const geometry::Point cellCenter(pCell->left() + halfWidth,
+                                   pCell->bottom() + halfWidth);
+  world::Asteroid::Uptr pNewcomer = Tool::spawnAsteroid();
+  pNewcomer->moveTo(cellCenter);
+
+  stats = waitGlobalScan();
+  EXPECT_EQ(1, stats.nCellsChecked);
+  EXPECT_EQ(cells.size() - 1, stats.nCellsSkipped);
+  stats = waitGlobalScan();
+  EXPECT_EQ(0, stats.nCellsChecked);
+
+  UpdatesJournal newcomerJournal;
+  pickAllUpdates(newcomerJournal, pScanner);
+  ASSERT_EQ(1, newcomerJournal.allAsteroidsIds().count(
+              pNewcomer->getAsteroidId()));
+
+  // The newcomer leaves the cell and the scanning radius, so it should be
+  // forgotten
+  pNewcomer->moveTo(geometry::Point(2 * nScanningRadius, 0));
+  stats = waitGlobalScan();
+  EXPECT_EQ(1, stats.nCellsChecked);
+  justWait(m_nMaxUpdateTimeMs);
+  pickAllUpdates(newcomerJournal, pScanner);
+
+  UpdatesJournal farAwayJournal;
+  justWait(m_nMaxUpdateTimeMs);
+  pickAllUpdates(farAwayJournal, pScanner);
+  ASSERT_EQ(0, farAwayJournal.allAsteroidsIds().count(
+              pNewcomer->getAsteroidId()));
+
+  // ... and detected again, when it returns to the same cell
+  pNewcomer->moveTo(cellCenter);
+  stats = waitGlobalScan();
+  EXPECT_EQ(1, stats.nCellsChecked);
+
+  UpdatesJournal returnJournal;
+  justWait(m_nMaxUpdateTimeMs);
+  pickAllUpdates(returnJournal, pScanner);
+  ASSERT_EQ(1, returnJournal.allAsteroidsIds().count(
+              pNewcomer->getAsteroidId()));
+}
+
 }  // namespace autotests
@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+#include <google/protobuf/util/message_differencer.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <Network/BufferedProtobufTerminal.h>
+#include <Network/ProtobufChannel.h>
+#include <Utils/Clock.h>
+
+namespace autotests
+{
+
+class RecordingTerminal : public network::BufferedPlayerTerminal
+{
+public:
+  bool canOpenSession() const override { return true; }
+  void openSession(uint32_t) override {}
+  void onSessionClosed(uint32_t) override {}
+
+  std::vector<std::pair<uint32_t, spex::Message>> m_handled;
+
+protected:
+  void handleMessage(uint32_t nSessionId, spex::Message const& message) override
+  {
+    m_handled.emplace_back(nSessionId, message);
+  }
+};
+
+class BufferedProtobufTerminalTests : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_clock.switchToDebugMode();
+    m_clock.setDebugTickUs(1000);
+    m_clock.proceedRequest(0xFFFFFFFF);
+    m_clock.start(true);
+    utils::GlobalClock::set(&m_clock);
+
+    m_pChannel  = std::make_shared<network::PlayerChannel>();
+    m_pTerminal = std::make_shared<RecordingTerminal>();
+    m_pChannel->attachToTerminal(m_pTerminal);
+  }
+
+  void TearDown() override
+  {
+    utils::GlobalClock::reset();
+  }
+
+  spex::Message makeMessage(uint64_t nTimestamp, std::string const& sLogin)
+  {
+    spex::Message message;
+    message.set_timestamp(nTimestamp);
+    spex::IAccessPanel::LoginRequest* pReq =
+        message.mutable_accesspanel()->mutable_login();
+    pReq->set_login(sLogin);
+    pReq->set_password(std::string(512, '*'));
+    return message;
+  }
+
+  void receive(uint32_t nSessionId, spex::Message const& message)
+  {
+    // Message is parsed by the channel into it's arena, which is reset right
+    // after the message is passed to the terminal
+    std::string data;
+    message.SerializeToString(&data);
+    m_pChannel->onMessageReceived(
+          nSessionId, network::BinaryMessage(data.data(), data.size()));
+  }
+
+  static bool equal(spex::Message const& left, spex::Message const& right)
+  {
+    return google::protobuf::util::MessageDifferencer::Equals(left, right);
+  }
+
+protected:
+  utils::Clock                       m_clock;
+  network::PlayerChannelPtr          m_pChannel;
+  std::shared_ptr<RecordingTerminal> m_pTerminal;
+};
+
+TEST_F(BufferedProtobufTerminalTests, BufferedAndDelayedMessages)
+{
+  const spex::Message first   = makeMessage(0, "first");
+  const spex::Message delayed = makeMessage(5000, "delayed");
+  const spex::Message second  = makeMessage(0, "second");
+  receive(1, first);
+  receive(2, delayed);
+  receive(3, second);
+
+  m_pTerminal->handleBufferedMessages();
+  ASSERT_EQ(2, m_pTerminal->m_handled.size());
+  EXPECT_EQ(1, m_pTerminal->m_handled[0].first);
+  EXPECT_TRUE(equal(first, m_pTerminal->m_handled[0].second));
+  EXPECT_EQ(3, m_pTerminal->m_handled[1].first);
+  EXPECT_TRUE(equal(second, m_pTerminal->m_handled[1].second));
+
+  // Arena of the terminal has been reset, but the delayed message is still
+  // stored by the terminal
+  m_pTerminal->m_handled.clear();
+  while (m_clock.now() < 5000) {
+    m_clock.getNextInterval();
+    m_pTerminal->handleBufferedMessages();
+  }
+  ASSERT_EQ(1, m_pTerminal->m_handled.size());
+  EXPECT_EQ(2, m_pTerminal->m_handled[0].first);
+  EXPECT_TRUE(equal(delayed, m_pTerminal->m_handled[0].second));
+}
+
+TEST_F(BufferedProtobufTerminalTests, DelayedMessagesOrder)
+{
+  // Messages are handled in order of their timestamps; messages with the same
+  // timestamp are handled in order they have been received
+  const std::vector<uint64_t> timestamps = {9000, 3000, 7000, 3000, 5000,
+                                            9000, 2000, 7000, 4000, 3000};
+  for (size_t i = 0; i < timestamps.size(); ++i) {
+    receive(static_cast<uint32_t>(i),
+            makeMessage(timestamps[i], std::to_string(i)));
+  }
+  m_pTerminal->handleBufferedMessages();
+  EXPECT_TRUE(m_pTerminal->m_handled.empty());
+  EXPECT_EQ(timestamps.size(), m_pTerminal->getDelayedQueueStats().nQueued);
+
+  while (m_clock.now() < 10000) {
+    m_clock.getNextInterval();
+    m_pTerminal->handleBufferedMessages();
+  }
+  const std::vector<uint32_t> expected = {6, 1, 3, 9, 8, 4, 2, 7, 0, 5};
+  std::vector<uint32_t> handled;
+  for (auto const& item: m_pTerminal->m_handled) {
+    handled.push_back(item.first);
+    EXPECT_EQ(std::to_string(item.first),
+              item.second.accesspanel().login().login());
+  }
+  EXPECT_EQ(expected, handled);
+  EXPECT_EQ(0, m_pTerminal->getDelayedQueueStats().nQueued);
+}
+
+TEST_F(BufferedProtobufTerminalTests, DelayedMessagesLimits)
+{
+  // One session can't take the whole queue of delayed messages
+  const size_t nPerSessionLimit = RecordingTerminal::nDelayedPerSessionLimit;
+  for (size_t i = 0; i < nPerSessionLimit + 10; ++i) {
+    receive(1, makeMessage(5000 + i, "greedy"));
+  }
+  receive(2, makeMessage(5000, "modest"));
+  m_pTerminal->handleBufferedMessages();
+
+  RecordingTerminal::DelayedQueueStats stats =
+      m_pTerminal->getDelayedQueueStats();
+  EXPECT_EQ(nPerSessionLimit + 1, stats.nQueued);
+  EXPECT_EQ(10, stats.nDroppedBySessionLimit);
+  EXPECT_EQ(0, stats.nDroppedByTotalLimit);
+
+  // Once delayed messages are handled, session may schedule messages again
+  while (m_clock.now() < 5000 + nPerSessionLimit) {
+    m_clock.getNextInterval();
+    m_pTerminal->handleBufferedMessages();
+  }
+  EXPECT_EQ(nPerSessionLimit + 1, m_pTerminal->m_handled.size());
+  receive(1, makeMessage(m_clock.now() + 1000, "greedy"));
+  m_pTerminal->handleBufferedMessages();
+  stats = m_pTerminal->getDelayedQueueStats();
+  EXPECT_EQ(1, stats.nQueued);
+  EXPECT_EQ(10, stats.nDroppedBySessionLimit);
+}
+
+TEST_F(BufferedProtobufTerminalTests, DelayedQueueTotalLimit)
+{
+  // Many sessions, each of them is under the per-session limit, can't make
+  // the queue of delayed messages longer than the total limit
+  const size_t nTotalLimit = RecordingTerminal::nDelayedQueueLimit;
+  const size_t nSessions   = 20;
+  const size_t nMessagesPerSession =
+      RecordingTerminal::nDelayedPerSessionLimit - 6;
+  ASSERT_LT(nTotalLimit, nSessions * nMessagesPerSession);
+
+  for (uint32_t nSessionId = 0; nSessionId < nSessions; ++nSessionId) {
+    for (size_t i = 0; i < nMessagesPerSession; ++i) {
+      receive(nSessionId, makeMessage(5000 + i, std::to_string(nSessionId)));
+    }
+  }
+  m_pTerminal->handleBufferedMessages();
+
+  RecordingTerminal::DelayedQueueStats stats =
+      m_pTerminal->getDelayedQueueStats();
+  EXPECT_EQ(nTotalLimit, stats.nQueued);
+  EXPECT_EQ(nSessions * nMessagesPerSession - nTotalLimit,
+            stats.nDroppedByTotalLimit);
+  EXPECT_EQ(0, stats.nDroppedBySessionLimit);
+
+  // The queue is full, so the next message is dropped as well
+  receive(nSessions, makeMessage(5000, "late"));
+  m_pTerminal->handleBufferedMessages();
+  stats = m_pTerminal->getDelayedQueueStats();
+  EXPECT_EQ(nTotalLimit, stats.nQueued);
+  EXPECT_EQ(nSessions * nMessagesPerSession - nTotalLimit + 1,
+            stats.nDroppedByTotalLimit);
+
+  while (m_clock.now() < 5000 + nMessagesPerSession) {
+    m_clock.getNextInterval();
+    m_pTerminal->handleBufferedMessages();
+  }
+  EXPECT_EQ(nTotalLimit, m_pTerminal->m_handled.size());
+  EXPECT_EQ(0, m_pTerminal->getDelayedQueueStats().nQueued);
+}
+
+} // namespace autotests
@@ -3,6 +3,7 @@
 #include <Network/ProtobufChannel.h>
 #include <Protocol.pb.h>
 #include <Autotests/Mocks/MockedBaseModule.h>
+#include <Autotests/Mocks/MockedBinaryChannel.h>
 
 namespace autotests
 {
@@ -118,4 +119,34 @@ TEST_F(ProtobufChannelTests, LotsOfMessageSimultaneously)
   }
 }
 
+TEST_F(ProtobufChannelTests, BatchedSending)
+{
+  auto pBinaryChannel = std::make_shared<MockedBinaryChannel>();
+  m_pChannel->attachToChannel(pBinaryChannel);
+  ASSERT_TRUE(m_pChannel->enableBatching());
+
+  std::vector<spex::Message> messages;
+  createSomeMessages(messages);
+  for (spex::Message const& message: messages) {
+    spex::Message copy(message);
+    ASSERT_TRUE(m_pChannel->send(0, std::move(copy)));
+  }
+
+  // Coalesced datagrams are parsed as a single batch
+  std::string datagram;
+  for (MockedBinaryChannel::Datagram const& item: pBinaryChannel->m_sent) {
+    datagram += item.data;
+  }
+  spex::Message batch;
+  ASSERT_TRUE(batch.ParseFromString(datagram));
+  ASSERT_EQ(messages.size(), batch.batch_size());
+  for (size_t i = 0; i < messages.size(); ++i) {
+    EXPECT_TRUE(google::protobuf::util::MessageDifferencer::Equals(
+                  messages[i], batch.batch(static_cast<int>(i))));
+  }
+
+  // Batches are not supported by privileged protocol
+  EXPECT_FALSE(network::PrivilegedChannel().enableBatching());
+}
+
 } // namespace autotests
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include <google/protobuf/util/message_differencer.h>
+
+#include <vector>
+
+#include <Network/SessionMux.h>
+#include <Network/ProtobufChannel.h>
+#include <Autotests/Mocks/MockedBaseModule.h>
+#include <Autotests/Mocks/MockedBinaryChannel.h>
+
+namespace autotests
+{
+
+class SessionMuxTests : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_pSessionMux      = std::make_shared<network::SessionMux>();
+    m_pProtobufChannel = std::make_shared<network::PlayerChannel>();
+    m_pBinaryChannel   = std::make_shared<MockedBinaryChannel>();
+    m_pModule          = std::make_shared<MockedBaseModule>();
+
+    m_pProtobufChannel->attachToChannel(m_pBinaryChannel);
+    m_pProtobufChannel->attachToTerminal(m_pSessionMux->asTerminal());
+    m_pSessionMux->asTerminal()->attachToChannel(m_pProtobufChannel);
+  }
+
+  void TearDown() override
+  {
+    m_pSessionMux->asTerminal()->detachFromChannel();
+    m_pSessionMux->markAllConnectionsAsClosed();
+  }
+
+protected:
+  std::shared_ptr<network::SessionMux> m_pSessionMux;
+  network::PlayerChannelPtr            m_pProtobufChannel;
+  MockedBinaryChannelPtr               m_pBinaryChannel;
+  MockedBaseModulePtr                  m_pModule;
+};
+
+TEST_F(SessionMuxTests, BroadcastIsEqualToSeparateSending)
+{
+  const uint32_t nFirstRoot  = m_pSessionMux->addConnection(0, m_pModule);
+  const uint32_t nSecondRoot = m_pSessionMux->addConnection(1, m_pModule);
+  const std::vector<uint32_t> sessions = {
+    nFirstRoot,
+    m_pSessionMux->createSession(nFirstRoot, m_pModule),
+    nSecondRoot,
+    m_pSessionMux->createSession(nSecondRoot, m_pModule)
+  };
+
+  spex::Message message;
+  auto* pUpdate = message.mutable_passive_scanner()->mutable_update();
+  for (uint32_t i = 0; i < 16; ++i) {
+    spex::PhysicalObject* pItem = pUpdate->add_items();
+    pItem->set_id(i);
+    pItem->set_x(i * 100.5);
+    pItem->set_y(i * -32.25);
+  }
+
+  // Broadcast and separate sending are compared, so an invalid session
+  // should be skipped by both of them
+  std::vector<uint32_t> recipients = sessions;
+  recipients.push_back(sessions.back() + 1);
+
+  network::IPlayerChannelPtr pChannel = m_pSessionMux->asChannel();
+  EXPECT_EQ(sessions.size(),
+            pChannel->broadcast(recipients.data(), recipients.size(), message));
+  std::vector<MockedBinaryChannel::Datagram> broadcasted;
+  std::swap(broadcasted, m_pBinaryChannel->m_sent);
+
+  for (uint32_t nSessionId: recipients) {
+    spex::Message copy(message);
+    pChannel->send(nSessionId, std::move(copy));
+  }
+  ASSERT_EQ(sessions.size(), broadcasted.size());
+  ASSERT_EQ(sessions.size(), m_pBinaryChannel->m_sent.size());
+
+  for (size_t i = 0; i < sessions.size(); ++i) {
+    MockedBinaryChannel::Datagram const& expected = m_pBinaryChannel->m_sent[i];
+    EXPECT_EQ(expected.nSessionId, broadcasted[i].nSessionId);
+
+    spex::Message expectedMessage;
+    spex::Message receivedMessage;
+    ASSERT_TRUE(expectedMessage.ParseFromString(expected.data));
+    ASSERT_TRUE(receivedMessage.ParseFromString(broadcasted[i].data));
+    EXPECT_EQ(sessions[i], receivedMessage.tunnelid());
+    EXPECT_TRUE(google::protobuf::util::MessageDifferencer::Equals(
+                  expectedMessage, receivedMessage));
+  }
+}
+
+} // namespace autotests
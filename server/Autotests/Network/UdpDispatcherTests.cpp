@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Network/UdpDispatcher.h>
+#include <Network/UdpSocket.h>
+
+namespace autotests
+{
+
+class DispatchedTerminal : public network::IBinaryTerminal
+{
+public:
+  bool canOpenSession() const override { return true; }
+  void openSession(uint32_t) override {}
+  void onMessageReceived(uint32_t, network::BinaryMessage const& frame) override
+  {
+    m_received.emplace_back(reinterpret_cast<char const*>(frame.m_pBody),
+                            frame.m_nLength);
+    m_receivedBy.push_back(std::this_thread::get_id());
+  }
+  void onSessionClosed(uint32_t) override {}
+  void attachToChannel(network::IBinaryChannelPtr) override {}
+  void detachFromChannel() override {}
+
+  std::vector<std::string>     m_received;
+  std::vector<std::thread::id> m_receivedBy;
+};
+
+TEST(UdpDispatcherTests, IoThreadMode)
+{
+  boost::asio::io_service ioContext;
+  auto pDispatcher =
+      std::make_shared<network::UdpDispatcher>(ioContext, 27000, 27100, true);
+
+  network::UdpSocketPtr pSender   = pDispatcher->createUdpSocket();
+  network::UdpSocketPtr pReceiver = pDispatcher->createUdpSocket();
+  ASSERT_TRUE(pSender && pReceiver);
+
+  auto pSenderTerminal   = std::make_shared<DispatchedTerminal>();
+  auto pReceiverTerminal = std::make_shared<DispatchedTerminal>();
+  pSender->attachToTerminal(pSenderTerminal);
+  pReceiver->attachToTerminal(pReceiverTerminal);
+
+  const auto localhost = boost::asio::ip::address_v4::loopback();
+  const uint32_t nSessionId = *pSender->createPersistentSession(
+        boost::asio::ip::udp::endpoint(
+          localhost, pReceiver->getLocalAddr().port()));
+  pReceiver->createPersistentSession(
+        boost::asio::ip::udp::endpoint(
+          localhost, pSender->getLocalAddr().port()));
+
+  std::vector<std::string> messages;
+  for (size_t i = 0; i < 50; ++i) {
+    messages.push_back("message #" + std::to_string(i));
+    ASSERT_TRUE(pSender->send(
+                  nSessionId,
+                  network::BinaryMessage(messages.back().data(),
+                                         messages.back().size())));
+  }
+  pDispatcher->flush();
+
+  // Datagrams are received by I/O thread, but are handed to the terminal
+  // only by the conveyor
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_TRUE(pReceiverTerminal->m_received.empty());
+
+  for (size_t i = 0;
+       i < 1000 && pReceiverTerminal->m_received.size() < messages.size();
+       ++i) {
+    EXPECT_FALSE(pDispatcher->prephare(0, 0, 0));
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(messages, pReceiverTerminal->m_received);
+  for (std::thread::id const& threadId: pReceiverTerminal->m_receivedBy) {
+    EXPECT_EQ(std::this_thread::get_id(), threadId);
+  }
+
+  // Sockets may be destroyed while I/O thread is running
+  pSender.reset();
+  pReceiver.reset();
+}
+
+TEST(UdpDispatcherTests, DestroyWhileSending)
+{
+  boost::asio::io_service ioContext;
+  auto pDispatcher =
+      std::make_shared<network::UdpDispatcher>(ioContext, 27100, 27200, true);
+
+  network::UdpSocketPtr pReceiver = pDispatcher->createUdpSocket();
+  ASSERT_TRUE(pReceiver);
+  pReceiver->attachToTerminal(std::make_shared<DispatchedTerminal>());
+
+  // Loopback never reports that the socket's buffer is full, but a datagram,
+  // that is longer than UDP allows, makes 'sendmmsg()' fail as well, so all
+  // queued datagrams are sent asynchronously by the I/O thread
+  const std::string oversized(70000, 'x');
+  const std::string message = "message";
+  const auto localhost = boost::asio::ip::address_v4::loopback();
+  for (size_t i = 0; i < 20; ++i) {
+    network::UdpSocketPtr pSender = pDispatcher->createUdpSocket();
+    ASSERT_TRUE(pSender);
+    pSender->attachToTerminal(std::make_shared<DispatchedTerminal>());
+    const uint32_t nSessionId = *pSender->createPersistentSession(
+          boost::asio::ip::udp::endpoint(
+            localhost, pReceiver->getLocalAddr().port()));
+
+    ASSERT_TRUE(pSender->send(
+                  nSessionId,
+                  network::BinaryMessage(oversized.data(), oversized.size())));
+    for (size_t j = 0; j < 100; ++j) {
+      ASSERT_TRUE(pSender->send(
+                    nSessionId,
+                    network::BinaryMessage(message.data(), message.size())));
+    }
+    pSender->flush();
+    // Socket should wait for all sends, that are still pending
+    pSender.reset();
+  }
+}
+
+} // namespace autotests
@@ -0,0 +1,397 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <google/protobuf/util/message_differencer.h>
+
+#include <Network/Fwd.h>
+#include <Network/UdpSocket.h>
+#include <Network/ProtobufChannel.h>
+
+namespace autotests
+{
+
+class ReceivingTerminal : public network::IBinaryTerminal
+{
+public:
+  bool canOpenSession() const override { return true; }
+  void openSession(uint32_t) override {}
+  void onMessageReceived(uint32_t nSessionId,
+                         network::BinaryMessage const& frame) override
+  {
+    m_received.emplace_back(reinterpret_cast<char const*>(frame.m_pBody),
+                            frame.m_nLength);
+    m_sessions.push_back(nSessionId);
+  }
+  void onSessionClosed(uint32_t) override {}
+  void attachToChannel(network::IBinaryChannelPtr) override {}
+  void detachFromChannel() override {}
+
+  std::vector<std::string> m_received;
+  std::vector<uint32_t>    m_sessions;
+};
+
+class UdpSocketTests : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_pSender   = std::make_shared<network::UdpSocket>(m_ioContext, 0, false);
+    m_pReceiver = std::make_shared<network::UdpSocket>(m_ioContext, 0, false);
+    m_pSenderTerminal   = std::make_shared<ReceivingTerminal>();
+    m_pReceiverTerminal = std::make_shared<ReceivingTerminal>();
+    m_pSender->attachToTerminal(m_pSenderTerminal);
+    m_pReceiver->attachToTerminal(m_pReceiverTerminal);
+
+    const auto localhost = boost::asio::ip::address_v4::loopback();
+    m_nSessionId = *m_pSender->createPersistentSession(
+          boost::asio::ip::udp::endpoint(
+            localhost, m_pReceiver->getLocalAddr().port()));
+    m_pReceiver->createPersistentSession(
+          boost::asio::ip::udp::endpoint(
+            localhost, m_pSender->getLocalAddr().port()));
+  }
+
+  bool waitReceived(size_t nTotal)
+  {
+    for (size_t i = 0; i < 1000; ++i) {
+      m_ioContext.poll();
+      if (m_pReceiverTerminal->m_received.size() >= nTotal) {
+        return true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+  }
+
+protected:
+  boost::asio::io_service            m_ioContext;
+  network::UdpSocketPtr              m_pSender;
+  network::UdpSocketPtr              m_pReceiver;
+  std::shared_ptr<ReceivingTerminal> m_pSenderTerminal;
+  std::shared_ptr<ReceivingTerminal> m_pReceiverTerminal;
+  uint32_t                           m_nSessionId = 0;
+};
+
+TEST_F(UdpSocketTests, BatchedSending)
+{
+  m_pSender->enableBatchedSending();
+
+  std::vector<std::string> messages;
+  for (size_t i = 0; i < 64; ++i) {
+    messages.push_back("message #" + std::to_string(i)
+                       + std::string(i * 10, '*'));
+    ASSERT_TRUE(m_pSender->send(
+                  m_nSessionId,
+                  network::BinaryMessage(messages.back().data(),
+                                         messages.back().size())));
+  }
+  // Messages are queued until flush() is called
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  m_ioContext.poll();
+  EXPECT_TRUE(m_pReceiverTerminal->m_received.empty());
+
+  m_pSender->flush();
+  ASSERT_TRUE(waitReceived(messages.size()));
+  EXPECT_EQ(messages, m_pReceiverTerminal->m_received);
+
+  // Nothing is sent twice
+  m_pSender->flush();
+  EXPECT_FALSE(waitReceived(messages.size() + 1));
+}
+
+TEST_F(UdpSocketTests, CoalescedSending)
+{
+  m_pSender->enableBatchedSending();
+  m_pSender->enableCoalescing();
+
+  // Messages for the receiver are interleaved with messages for another
+  // remote, they shouldn't be mixed up
+  auto pAnotherReceiver =
+      std::make_shared<network::UdpSocket>(m_ioContext, 0, false);
+  auto pAnotherTerminal = std::make_shared<ReceivingTerminal>();
+  pAnotherReceiver->attachToTerminal(pAnotherTerminal);
+  const auto localhost = boost::asio::ip::address_v4::loopback();
+  const uint32_t nAnotherSessionId = *m_pSender->createPersistentSession(
+        boost::asio::ip::udp::endpoint(
+          localhost, pAnotherReceiver->getLocalAddr().port()));
+  pAnotherReceiver->createPersistentSession(
+        boost::asio::ip::udp::endpoint(
+          localhost, m_pSender->getLocalAddr().port()));
+
+  std::string expected;
+  std::string expectedByAnother;
+  std::vector<std::string> messages;
+  for (size_t i = 0; i < 200; ++i) {
+    messages.push_back("message #" + std::to_string(i) + ";");
+    const bool lToAnother = i % 3 == 0;
+    (lToAnother ? expectedByAnother : expected) += messages.back();
+    ASSERT_TRUE(m_pSender->send(
+                  lToAnother ? nAnotherSessionId : m_nSessionId,
+                  network::BinaryMessage(messages.back().data(),
+                                         messages.back().size())));
+  }
+  m_pSender->flush();
+
+  // All messages are received in the same order, but in a few datagrams
+  std::string received;
+  std::string receivedByAnother;
+  for (size_t i = 0; i < 1000; ++i) {
+    m_ioContext.poll();
+    received.clear();
+    receivedByAnother.clear();
+    for (std::string const& datagram: m_pReceiverTerminal->m_received) {
+      received += datagram;
+    }
+    for (std::string const& datagram: pAnotherTerminal->m_received) {
+      receivedByAnother += datagram;
+    }
+    if (received.size() == expected.size()
+        && receivedByAnother.size() == expectedByAnother.size()) {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(expected, received);
+  EXPECT_EQ(expectedByAnother, receivedByAnother);
+
+  const size_t nMaxDatagramSize = network::UdpSocket::nMaxDatagramSize;
+  const size_t nMinDatagrams = (expected.size() + nMaxDatagramSize - 1)
+                               / nMaxDatagramSize;
+  EXPECT_LE(nMinDatagrams, m_pReceiverTerminal->m_received.size());
+  EXPECT_GE(nMinDatagrams + 1, m_pReceiverTerminal->m_received.size());
+  for (std::string const& datagram: m_pReceiverTerminal->m_received) {
+    EXPECT_GE(nMaxDatagramSize, datagram.size());
+  }
+}
+
+TEST_F(UdpSocketTests, ImmediateSending)
+{
+  const std::string message = "some message";
+  ASSERT_TRUE(m_pSender->send(
+                m_nSessionId,
+                network::BinaryMessage(message.data(), message.size())));
+  ASSERT_TRUE(waitReceived(1));
+  EXPECT_EQ(message, m_pReceiverTerminal->m_received.front());
+}
+
+TEST_F(UdpSocketTests, PromiscReceiving)
+{
+  // Receiver should open a new session for every datagram from unknown
+  // senders (more datagrams, than could be read by one syscall)
+  auto pPromisc  = std::make_shared<network::UdpSocket>(m_ioContext, 0, true);
+  auto pTerminal = std::make_shared<ReceivingTerminal>();
+  pPromisc->attachToTerminal(pTerminal);
+  const uint32_t nSessionId = *m_pSender->createPersistentSession(
+        boost::asio::ip::udp::endpoint(
+          boost::asio::ip::address_v4::loopback(),
+          pPromisc->getLocalAddr().port()));
+
+  m_pSender->enableBatchedSending();
+  std::vector<std::string> messages;
+  for (size_t i = 0; i < 100; ++i) {
+    messages.push_back("request #" + std::to_string(i));
+    ASSERT_TRUE(m_pSender->send(
+                  nSessionId,
+                  network::BinaryMessage(messages.back().data(),
+                                         messages.back().size())));
+  }
+  m_pSender->flush();
+
+  for (size_t i = 0; i < 1000 && pTerminal->m_received.size() < 100; ++i) {
+    m_ioContext.poll();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(messages, pTerminal->m_received);
+  // Sessions are not closed by terminal, so every datagram gets a new one
+  const std::set<uint32_t> sessions(pTerminal->m_sessions.begin(),
+                                    pTerminal->m_sessions.end());
+  EXPECT_EQ(messages.size(), sessions.size());
+}
+
+class ReplyingTerminal : public ReceivingTerminal
+{
+public:
+  void onMessageReceived(uint32_t nSessionId,
+                         network::BinaryMessage const& frame) override
+  {
+    ReceivingTerminal::onMessageReceived(nSessionId, frame);
+    m_pSocket->send(nSessionId,
+                    network::BinaryMessage(frame.m_pBody, frame.m_nLength));
+  }
+
+  network::UdpSocketPtr m_pSocket;
+};
+
+TEST_F(UdpSocketTests, PromiscSessionsAreReused)
+{
+  // Promisc socket closes a session once it has replied, so the session
+  // can be used by the next datagram. Much more requests, than the number
+  // of sessions, should be answered.
+  auto pPromisc  = std::make_shared<network::UdpSocket>(m_ioContext, 0, true);
+  auto pTerminal = std::make_shared<ReplyingTerminal>();
+  pTerminal->m_pSocket = pPromisc;
+  pPromisc->attachToTerminal(pTerminal);
+  const uint32_t nSessionId = *m_pSender->createPersistentSession(
+        boost::asio::ip::udp::endpoint(
+          boost::asio::ip::address_v4::loopback(),
+          pPromisc->getLocalAddr().port()));
+
+  m_pSender->enableBatchedSending();
+  const size_t nTotalRequests = 2000;
+  std::set<std::string> requests;
+  for (size_t i = 0; i < nTotalRequests; ++i) {
+    const std::string request = "request #" + std::to_string(i);
+    requests.insert(request);
+    ASSERT_TRUE(m_pSender->send(
+                  nSessionId,
+                  network::BinaryMessage(request.data(), request.size())));
+    if (i % 100 == 99) {
+      m_pSender->flush();
+      for (size_t j = 0; j < 1000; ++j) {
+        m_ioContext.poll();
+        if (m_pSenderTerminal->m_received.size() == i + 1) {
+          break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+  }
+
+  EXPECT_EQ(nTotalRequests, pTerminal->m_received.size());
+  const std::set<std::string> replies(m_pSenderTerminal->m_received.begin(),
+                                      m_pSenderTerminal->m_received.end());
+  EXPECT_EQ(requests, replies);
+  // All sessions have been closed, so only a few of them have been used
+  const std::set<uint32_t> sessions(pTerminal->m_sessions.begin(),
+                                    pTerminal->m_sessions.end());
+  EXPECT_GE(100, sessions.size());
+  pTerminal->m_pSocket.reset();
+}
+
+TEST_F(UdpSocketTests, SerializationIntoChunks)
+{
+  // Protobuf channel serializes messages right into the socket's chunks
+  auto pChannel = std::make_shared<network::PlayerChannel>();
+  pChannel->attachToChannel(m_pSender);
+
+  spex::Message message;
+  message.set_tunnelid(42);
+  message.mutable_accesspanel()->set_access_rejected("some reason");
+
+  spex::Message copy(message);
+  ASSERT_TRUE(pChannel->send(m_nSessionId, std::move(copy)));
+  ASSERT_TRUE(waitReceived(1));
+  EXPECT_EQ(message.SerializeAsString(),
+            m_pReceiverTerminal->m_received.front());
+
+  // The same, but in batched mode and with coalescing
+  m_pSender->enableBatchedSending();
+  m_pSender->enableCoalescing();
+  ASSERT_TRUE(pChannel->enableBatching());
+  for (size_t i = 0; i < 2; ++i) {
+    spex::Message copy(message);
+    ASSERT_TRUE(pChannel->send(m_nSessionId, std::move(copy)));
+  }
+  m_pSender->flush();
+  ASSERT_TRUE(waitReceived(2));
+
+  spex::Message batch;
+  ASSERT_TRUE(batch.ParseFromString(m_pReceiverTerminal->m_received.back()));
+  ASSERT_EQ(2, batch.batch_size());
+  for (spex::Message const& item: batch.batch()) {
+    EXPECT_TRUE(
+          google::protobuf::util::MessageDifferencer::Equals(message, item));
+  }
+}
+
+TEST_F(UdpSocketTests, SerializedBodyIntoSocket)
+{
+  // A body, that has been serialized once for several sessions, is written
+  // to the socket's chunks together with the session specific header
+  auto pChannel = std::make_shared<network::PlayerChannel>();
+  pChannel->attachToChannel(m_pSender);
+
+  spex::Message message;
+  message.mutable_accesspanel()->set_access_rejected("some reason");
+  const std::string body = message.SerializeAsString();
+
+  spex::Message header;
+  header.set_tunnelid(42);
+  ASSERT_TRUE(pChannel->sendSerialized(m_nSessionId, body, header));
+  ASSERT_TRUE(waitReceived(1));
+
+  spex::Message expected(message);
+  expected.set_tunnelid(42);
+  spex::Message received;
+  ASSERT_TRUE(received.ParseFromString(m_pReceiverTerminal->m_received.front()));
+  EXPECT_TRUE(
+        google::protobuf::util::MessageDifferencer::Equals(expected, received));
+
+  // The same, but in batched mode and with coalescing
+  m_pSender->enableBatchedSending();
+  m_pSender->enableCoalescing();
+  ASSERT_TRUE(pChannel->enableBatching());
+  for (uint32_t nTunnelId: {7, 8}) {
+    header.set_tunnelid(nTunnelId);
+    ASSERT_TRUE(pChannel->sendSerialized(m_nSessionId, body, header));
+  }
+  m_pSender->flush();
+  ASSERT_TRUE(waitReceived(2));
+
+  spex::Message batch;
+  ASSERT_TRUE(batch.ParseFromString(m_pReceiverTerminal->m_received.back()));
+  ASSERT_EQ(2, batch.batch_size());
+  for (uint32_t nTunnelId: {7, 8}) {
+    expected.set_tunnelid(nTunnelId);
+    EXPECT_TRUE(google::protobuf::util::MessageDifferencer::Equals(
+                  expected, batch.batch(nTunnelId - 7)));
+  }
+}
+
+TEST_F(UdpSocketTests, ConcurrentSerialization)
+{
+  // Messages are serialized by several threads at the same time (outside of
+  // the socket's lock), none of them should be lost or corrupted
+  auto pChannel = std::make_shared<network::PlayerChannel>();
+  pChannel->attachToChannel(m_pSender);
+  m_pSender->enableBatchedSending();
+
+  const uint32_t nTotalThreads      = 4;
+  const uint32_t nMessagesPerThread = 25;
+  std::vector<std::thread> threads;
+  for (uint32_t nThread = 0; nThread < nTotalThreads; ++nThread) {
+    threads.emplace_back([&pChannel, this, nThread]() {
+      for (uint32_t i = 0; i < nMessagesPerThread; ++i) {
+        spex::Message message;
+        message.set_tunnelid(nThread * nMessagesPerThread + i);
+        message.mutable_accesspanel()->set_access_rejected(
+              std::string(i, 'a' + static_cast<char>(nThread)));
+        pChannel->send(m_nSessionId, std::move(message));
+      }
+    });
+  }
+  for (std::thread& thread: threads) {
+    thread.join();
+  }
+  m_pSender->flush();
+  ASSERT_TRUE(waitReceived(nTotalThreads * nMessagesPerThread));
+
+  std::set<uint32_t> tunnels;
+  for (std::string const& datagram: m_pReceiverTerminal->m_received) {
+    spex::Message message;
+    ASSERT_TRUE(message.ParseFromString(datagram));
+    const uint32_t nThread = message.tunnelid() / nMessagesPerThread;
+    const uint32_t i       = message.tunnelid() % nMessagesPerThread;
+    EXPECT_EQ(std::string(i, 'a' + static_cast<char>(nThread)),
+              message.accesspanel().access_rejected());
+    tunnels.insert(message.tunnelid());
+  }
+  EXPECT_EQ(nTotalThreads * nMessagesPerThread, tunnels.size());
+}
+
+} // namespace autotests
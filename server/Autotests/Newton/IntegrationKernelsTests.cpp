@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include <Newton/IntegrationKernels.h>
+#include <Geometry/Point.h>
+#include <Geometry/Vector.h>
+
+namespace autotests {
+
+// Bodies with random state. Contains both: bodies with and without forces
+struct RandomBodies
+{
+  RandomBodies(size_t nTotal, unsigned int nSeed)
+    : x(nTotal), y(nTotal), vx(nTotal), vy(nTotal),
+      fx(nTotal), fy(nTotal), weight(nTotal), invMass(nTotal)
+  {
+    std::mt19937 generator(nSeed);
+    std::uniform_real_distribution<double> position(-1e9, 1e9);
+    std::uniform_real_distribution<double> velocity(-1e4, 1e4);
+    std::uniform_real_distribution<double> force(-1e6, 1e6);
+    std::uniform_real_distribution<double> mass(1, 1e6);
+    for (size_t i = 0; i < nTotal; ++i) {
+      x[i]       = position(generator);
+      y[i]       = position(generator);
+      vx[i]      = velocity(generator);
+      vy[i]      = velocity(generator);
+      fx[i]      = (i % 3) ? 0 : force(generator);
+      fy[i]      = (i % 3) ? 0 : force(generator);
+      weight[i]  = mass(generator);
+      invMass[i] = 1 / weight[i];
+    }
+  }
+
+  newton::BodiesArrays arrays()
+  {
+    newton::BodiesArrays bodies;
+    bodies.x       = x.data();
+    bodies.y       = y.data();
+    bodies.vx      = vx.data();
+    bodies.vy      = vy.data();
+    bodies.fx      = fx.data();
+    bodies.fy      = fy.data();
+    bodies.invMass = invMass.data();
+    return bodies;
+  }
+
+  // The same calculation, that used to be performed by NewtonEngine
+  // for every PhysicalObject
+  void integrateReference(size_t nBegin, size_t nEnd, double nIntervalSec)
+  {
+    for (size_t i = nBegin; i < nEnd; ++i) {
+      geometry::Point  position(x[i], y[i]);
+      geometry::Vector velocity(vx[i], vy[i]);
+      geometry::Vector acc_t(fx[i], fy[i]);
+      acc_t *= nIntervalSec / weight[i];
+
+      geometry::Vector movement(velocity, nIntervalSec);
+      movement.add(acc_t, nIntervalSec * 0.5);
+      position.translate(movement);
+      velocity += acc_t;
+
+      x[i]  = position.x;
+      y[i]  = position.y;
+      vx[i] = velocity.getX();
+      vy[i] = velocity.getY();
+    }
+  }
+
+  std::vector<double> x, y, vx, vy, fx, fy, weight, invMass;
+};
+
+static void expectNear(std::vector<double> const& expected,
+                       std::vector<double> const& actual)
+{
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    const double nTolerance = 1e-12 * std::max(1.0, std::abs(expected[i]));
+    ASSERT_NEAR(expected[i], actual[i], nTolerance) << "at index " << i;
+  }
+}
+
+
+class IntegrationKernelsTests :
+    public ::testing::TestWithParam<newton::KernelType>
+{};
+
+TEST_P(IntegrationKernelsTests, SameAsReference)
+{
+  if (!newton::isKernelSupported(GetParam())) {
+    GTEST_SKIP() << "Kernel is not supported by CPU";
+  }
+  newton::IntegrationKernel fIntegrate = newton::getKernel(GetParam());
+
+  // Odd range bounds to check, that tails are proceeded as well
+  const size_t nTotal = 1003;
+  const size_t nBegin = 3;
+  const size_t nEnd   = 1001;
+
+  RandomBodies expected(nTotal, 42);
+  RandomBodies actual(nTotal, 42);
+  for (double nIntervalSec : {0.001, 0.02, 0.5}) {
+    expected.integrateReference(nBegin, nEnd, nIntervalSec);
+    fIntegrate(actual.arrays(), nBegin, nEnd, nIntervalSec);
+  }
+
+  expectNear(expected.x,  actual.x);
+  expectNear(expected.y,  actual.y);
+  expectNear(expected.vx, actual.vx);
+  expectNear(expected.vy, actual.vy);
+}
+
+TEST_P(IntegrationKernelsTests, SameAsScalar)
+{
+  if (!newton::isKernelSupported(GetParam())) {
+    GTEST_SKIP() << "Kernel is not supported by CPU";
+  }
+  newton::IntegrationKernel fScalar =
+      newton::getKernel(newton::KernelType::eScalar);
+  newton::IntegrationKernel fIntegrate = newton::getKernel(GetParam());
+
+  RandomBodies expected(517, 17);
+  RandomBodies actual(517, 17);
+  fScalar(expected.arrays(), 1, 517, 0.01);
+  fIntegrate(actual.arrays(), 1, 517, 0.01);
+
+  // All kernels perform the same operations in the same order
+  EXPECT_EQ(expected.x,  actual.x);
+  EXPECT_EQ(expected.y,  actual.y);
+  EXPECT_EQ(expected.vx, actual.vx);
+  EXPECT_EQ(expected.vy, actual.vy);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    AllKernels, IntegrationKernelsTests,
+    ::testing::Values(newton::KernelType::eScalar,
+                      newton::KernelType::eSse2,
+                      newton::KernelType::eAvx));
+
+} // namespace autotests
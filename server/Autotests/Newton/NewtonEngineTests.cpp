@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include <Newton/NewtonEngine.h>
+#include <World/Grid.h>
+
+namespace autotests {
+
+class NewtonEngineTests : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_pPreviousGrid = world::Grid::getGlobal();
+    // 10 x 10 cells, 1000 x 1000 meters each, from -5000 to 5000
+    m_grid.build(10, 1000);
+    world::Grid::setGlobal(&m_grid);
+    // Storage may keep time of previous tests
+    newton::PhysicsStorage::instance().setNow(m_now);
+  }
+
+  void TearDown() override
+  {
+    world::Grid::setGlobal(m_pPreviousGrid);
+  }
+
+  void proceed(uint32_t nTicks, uint32_t nTickUs)
+  {
+    for (uint32_t i = 0; i < nTicks; ++i) {
+      m_now += nTickUs;
+      for (uint16_t nStageId = 0; nStageId < m_engine.getStagesCount();
+           ++nStageId) {
+        if (m_engine.prephare(nStageId, nTickUs, m_now)) {
+          m_engine.proceed(nStageId, nTickUs, m_now);
+        }
+      }
+    }
+  }
+
+  bool isInCell(newton::PhysicalObject const& object, double x, double y) const
+  {
+    world::Cell const* pCell = m_grid.getCell(x, y);
+    return pCell && pCell->getObjects().has(object.getInstanceId());
+  }
+
+protected:
+  world::Grid          m_grid;
+  world::Grid*         m_pPreviousGrid = nullptr;
+  newton::NewtonEngine m_engine;
+  uint64_t             m_now = 0;
+};
+
+TEST_F(NewtonEngineTests, ObjectWithoutForcesIsOnRails)
+{
+  newton::PhysicalObject object(10, 1);
+  object.moveTo(geometry::Point(100, 100));
+  object.setVelocity(geometry::Vector(100, 0));
+
+  proceed(1, 10000);
+  ASSERT_TRUE(isInCell(object, 100, 100));
+  EXPECT_TRUE(object.getPosition().almostEqual(geometry::Point(101, 100), 1e-6));
+
+  // In 8.99 seconds object is still in the same cell (x = 999)
+  proceed(899, 10000);
+  EXPECT_TRUE(object.getPosition().almostEqual(geometry::Point(1000, 100), 1e-6));
+  EXPECT_TRUE(isInCell(object, 100, 100));
+
+  // Object leaves it's cell
+  proceed(2, 10000);
+  EXPECT_TRUE(object.getPosition().almostEqual(geometry::Point(1002, 100), 1e-6));
+  EXPECT_FALSE(isInCell(object, 100, 100));
+  EXPECT_TRUE(isInCell(object, 1002, 100));
+}
+
+TEST_F(NewtonEngineTests, SwitchingForces)
+{
+  newton::PhysicalObject object(10, 1);
+  const size_t nForceId = object.createExternalForce();
+  object.setVelocity(geometry::Vector(0, 10));
+
+  // a = 1 m/s^2 during 1 second
+  object.setExternalForce(nForceId, geometry::Vector(10, 0));
+  proceed(100, 10000);
+  EXPECT_TRUE(object.getPosition().almostEqual(geometry::Point(0.5, 10), 1e-6));
+  EXPECT_TRUE(object.getVelocity().almostEqual(geometry::Vector(1, 10), 1e-6));
+
+  // Without forces object moves uniformly
+  object.setExternalForce(nForceId, geometry::Vector());
+  proceed(100, 10000);
+  EXPECT_TRUE(object.getPosition().almostEqual(geometry::Point(1.5, 20), 1e-6));
+  EXPECT_TRUE(object.getVelocity().almostEqual(geometry::Vector(1, 10), 1e-6));
+  EXPECT_TRUE(isInCell(object, 1.5, 20));
+}
+
+TEST_F(NewtonEngineTests, AcceleratedObjectLeavesCell)
+{
+  newton::PhysicalObject object(10, 1);
+  const size_t nForceId = object.createExternalForce();
+  object.moveTo(geometry::Point(500, -500));
+  proceed(1, 10000);
+  ASSERT_TRUE(isInCell(object, 500, -500));
+
+  // a = 100 m/s^2, so in 3 seconds object passes 450 meters
+  object.setExternalForce(nForceId, geometry::Vector(0, 1000));
+  proceed(300, 10000);
+  EXPECT_TRUE(object.getPosition().almostEqual(geometry::Point(500, -50), 1e-6));
+  EXPECT_TRUE(isInCell(object, 500, -500));
+
+  // In 3.2 seconds object passes 512 meters and crosses the border
+  proceed(20, 10000);
+  EXPECT_TRUE(object.getPosition().almostEqual(geometry::Point(500, 12), 1e-6));
+  EXPECT_FALSE(isInCell(object, 500, -500));
+  EXPECT_TRUE(isInCell(object, 500, 12));
+}
+
+} // namespace autotests
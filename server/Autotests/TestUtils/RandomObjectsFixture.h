@@ -0,0 +1,58 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include <Newton/PhysicalObject.h>
+#include <Utils/Randomizer.h>
+#include <World/Grid.h>
+
+namespace autotests {
+
+// Builds a grid of 20 x 20 cells, 1000 x 1000 meters each (from -10000 to
+// 10000), and spawns physical objects at random positions. Tests may install
+// 'm_grid' (or nullptr) as the global grid: the previous global grid is
+// restored by 'TearDown()'.
+class RandomObjectsFixture : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_pPreviousGrid = world::Grid::getGlobal();
+    m_grid.build(20, 1000);
+  }
+
+  void TearDown() override
+  {
+    world::Grid::setGlobal(m_pPreviousGrid);
+  }
+
+  void spawnObjects(uint32_t nPattern, double arenaHalfWidth,
+                    double minRadius, double maxRadius)
+  {
+    // Objects may be placed out of the grid's core, if the arena is wider
+    // than the core
+    const geometry::Rectangle arena(
+          geometry::Point(-arenaHalfWidth, arenaHalfWidth),
+          geometry::Point(arenaHalfWidth, -arenaHalfWidth));
+    utils::Randomizer::setPattern(nPattern);
+    for (uint32_t i = 0; i < 2000; ++i) {
+      geometry::Point position;
+      utils::Randomizer::yield(position, arena);
+      const double radius =
+          utils::Randomizer::yield<double>(minRadius, maxRadius);
+      m_objects.push_back(std::make_unique<newton::PhysicalObject>(1, radius));
+      m_objects.back()->moveTo(position);
+      m_grid.add(m_objects.back()->getInstanceId(), position.x, position.y);
+    }
+  }
+
+protected:
+  world::Grid  m_grid;
+  world::Grid* m_pPreviousGrid = nullptr;
+  std::vector<std::unique_ptr<newton::PhysicalObject>> m_objects;
+};
+
+} // namespace autotests
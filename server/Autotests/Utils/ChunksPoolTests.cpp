@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include <Utils/ChunksPool.h>
+#include <Utils/Mutex.h>
+#include <Utils/Stopwatch.h>
+
+namespace autotests {
+
+TEST(ChunksPoolTests, SizeClasses)
+{
+  utils::ChunksPool pool({{128, 2}, {64, 2}}, 1);
+
+  // Chunks of the smallest suitable class are taken first, then larger
+  std::vector<uint8_t*> chunks;
+  for (size_t i = 0; i < 4; ++i) {
+    chunks.push_back(pool.get(50));
+    memset(chunks.back(), 0xFF, 50);
+  }
+  EXPECT_EQ(4, std::set<uint8_t*>(chunks.begin(), chunks.end()).size());
+
+  utils::ChunksPool::Stats stats = pool.getStats();
+  EXPECT_EQ(4, stats.nHits);
+  EXPECT_EQ(0, stats.nFallbacks);
+
+  // Pool is exhausted, so chunks are allocated on the heap
+  chunks.push_back(pool.get(50));
+  chunks.push_back(pool.get(1000));
+  memset(chunks.back(), 0xFF, 1000);
+  stats = pool.getStats();
+  EXPECT_EQ(4, stats.nHits);
+  EXPECT_EQ(2, stats.nFallbacks);
+  EXPECT_EQ(6, stats.nInUse);
+  EXPECT_EQ(6, stats.nHighWaterMark);
+
+  for (uint8_t* pChunk: chunks) {
+    pool.release(pChunk);
+  }
+  stats = pool.getStats();
+  EXPECT_EQ(0, stats.nInUse);
+  EXPECT_EQ(6, stats.nHighWaterMark);
+
+  // Released chunks are reused
+  const std::set<uint8_t*> released(chunks.begin(), chunks.begin() + 4);
+  for (size_t i = 0; i < 4; ++i) {
+    uint8_t* pChunk = pool.get(64);
+    EXPECT_EQ(1, released.count(pChunk));
+  }
+  EXPECT_EQ(8, pool.getStats().nHits);
+}
+
+TEST(ChunksPoolTests, ReleasingByAnotherThread)
+{
+  // Chunks, that have been taken by one thread, are released by another one,
+  // all chunks should return to their shards
+  const size_t nTotalChunks = 64;
+  utils::ChunksPool pool({{256, nTotalChunks}}, 4);
+
+  std::vector<uint8_t*> chunks;
+  std::thread producer([&pool, &chunks, nTotalChunks]() {
+    for (size_t i = 0; i < nTotalChunks; ++i) {
+      chunks.push_back(pool.get(256));
+    }
+  });
+  producer.join();
+  EXPECT_EQ(0, pool.getStats().nFallbacks);
+
+  std::thread consumer([&pool, &chunks]() {
+    for (uint8_t* pChunk: chunks) {
+      pool.release(pChunk);
+    }
+  });
+  consumer.join();
+
+  std::set<uint8_t*> retaken;
+  for (size_t i = 0; i < nTotalChunks; ++i) {
+    retaken.insert(pool.get(200));
+  }
+  EXPECT_EQ(std::set<uint8_t*>(chunks.begin(), chunks.end()), retaken);
+  EXPECT_EQ(0, pool.getStats().nFallbacks);
+}
+
+class ChunksPoolStressTests : public ::testing::Test
+{
+protected:
+  // Every thread takes a few chunks, fills them and then checks and releases
+  // them ('nRoundsCount' times). Return time, that all threads spent.
+  template<typename GetFunction, typename ReleaseFunction>
+  uint64_t run(size_t nRoundsCount, GetFunction&& fGet,
+               ReleaseFunction&& fRelease)
+  {
+    std::atomic_size_t nErrors(0);
+    auto fWorker = [&](uint8_t nPattern) {
+      std::vector<std::pair<uint8_t*, size_t>> chunks;
+      for (size_t nRound = 0; nRound < nRoundsCount; ++nRound) {
+        for (size_t i = 0; i < nChunksPerRound; ++i) {
+          const size_t nSize = 64 + (nRound * 7 + i * 13) % 900;
+          uint8_t* pChunk = fGet(nSize);
+          memset(pChunk, nPattern, nSize);
+          chunks.emplace_back(pChunk, nSize);
+        }
+        for (auto const& chunk: chunks) {
+          for (size_t i = 0; i < chunk.second; ++i) {
+            if (chunk.first[i] != nPattern) {
+              ++nErrors;
+              break;
+            }
+          }
+          fRelease(chunk.first);
+        }
+        chunks.clear();
+      }
+    };
+
+    utils::Stopwatch stopwatch;
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < nThreadsCount; ++i) {
+      threads.emplace_back(fWorker, static_cast<uint8_t>(i + 1));
+    }
+    for (std::thread& thread: threads) {
+      thread.join();
+    }
+    const uint64_t nElapsedUs = stopwatch.testUs();
+    EXPECT_EQ(0, nErrors.load());
+    return nElapsedUs;
+  }
+
+protected:
+  static constexpr size_t nThreadsCount   = 4;
+  static constexpr size_t nChunksPerRound = 8;
+
+  const std::vector<utils::ChunksPool::SizeClass> m_classes = {
+    {256, 128}, {512, 64}, {1024, 32}
+  };
+};
+
+TEST_F(ChunksPoolStressTests, ShardedPool)
+{
+  const size_t nRoundsCount = 1000;
+
+  utils::ChunksPool pool(m_classes, nThreadsCount);
+  run(nRoundsCount,
+      [&pool](size_t nSize) { return pool.get(nSize); },
+      [&pool](uint8_t* pChunk) { pool.release(pChunk); });
+  utils::ChunksPool::Stats stats = pool.getStats();
+  EXPECT_EQ(0, stats.nInUse);
+  EXPECT_EQ(nThreadsCount * nRoundsCount * nChunksPerRound,
+            stats.nHits + stats.nFallbacks);
+  EXPECT_LE(nChunksPerRound, stats.nHighWaterMark);
+}
+
+// This is a benchmark rather than a test, so it is disabled by default. Run
+// it with '--gtest_also_run_disabled_tests' flag.
+TEST_F(ChunksPoolStressTests, DISABLED_ShardedVsSingleLockedPool)
+{
+  const size_t nRoundsCount = 10000;
+
+  utils::ChunksPool sharded(m_classes, nThreadsCount);
+  const uint64_t nShardedUs = run(
+        nRoundsCount,
+        [&sharded](size_t nSize) { return sharded.get(nSize); },
+        [&sharded](uint8_t* pChunk) { sharded.release(pChunk); });
+
+  // The way the pool has been used by UdpSocket before: a single shard under
+  // an external lock
+  utils::ChunksPool single(m_classes, 1);
+  utils::Mutex      mutex;
+  const uint64_t nSingleUs = run(
+        nRoundsCount,
+        [&single, &mutex](size_t nSize) {
+          std::lock_guard<utils::Mutex> guard(mutex);
+          return single.get(nSize);
+        },
+        [&single, &mutex](uint8_t* pChunk) {
+          std::lock_guard<utils::Mutex> guard(mutex);
+          single.release(pChunk);
+        });
+
+  const uint64_t nHeapUs = run(
+        nRoundsCount,
+        [](size_t nSize) { return new uint8_t[nSize]; },
+        [](uint8_t* pChunk) { delete [] pChunk; });
+
+  std::cout << "Sharded pool: " << nShardedUs << " us, " <<
+               "single locked pool: " << nSingleUs << " us, " <<
+               "heap: " << nHeapUs << " us" << std::endl;
+}
+
+} // namespace autotests
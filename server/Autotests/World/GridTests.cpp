@@ -1,4 +1,6 @@
 #include <World/Grid.h>
+#include <map>
+#include <set>
 #include <gtest/gtest.h>
 #include <Utils/Randomizer.h>
 #include <Geometry/Point.h>
@@ -87,16 +89,18 @@ TEST(GridTests, TrackSinglePoint) {
       utils::Randomizer::setPattern(nCellWidth + i);
       Point point = createPoint(i, grid, nCellWidth / 10.0);
 
-      while (point.m_pCell) {
+      while (grid.contains(point.x(), point.y())) {
         point.m_position += point.m_velocity;
         point.m_pCell = point.m_pCell->track(point.m_id, point.x(), point.y());
-        if (point.m_pCell) {
-          ASSERT_TRUE(point.m_pCell->contains(point.x(), point.y()))
-              << "Case #" << i;
-        }
+        ASSERT_TRUE(point.m_pCell) << "Case #" << i;
+        ASSERT_TRUE(point.m_pCell->contains(point.x(), point.y()))
+            << "Case #" << i;
       }
-      // Point left the grid
-      ASSERT_FALSE(grid.contains(point.x(), point.y())) << "Case #" << i;
+      // Point left the core and got into the outer cell
+      ASSERT_EQ(uint64_t(grid.right() - grid.left()), point.m_pCell->width())
+          << "Case #" << i;
+      ASSERT_TRUE(point.m_pCell->getObjects().has(point.m_id))
+          << "Case #" << i;
     }
   }
 }
@@ -121,11 +125,9 @@ TEST(GridTests, TrackMultiplePoints) {
       std::set<uint32_t> objectsInbound;
       for (Point& point: points) {
         point.m_position += point.m_velocity;
-        if (point.m_pCell) {
-          point.m_pCell = point.m_pCell->track(point.m_id, point.x(), point.y());
-          if (point.m_pCell) {
-            objectsInbound.insert(point.m_id);
-          }
+        point.m_pCell = point.m_pCell->track(point.m_id, point.x(), point.y());
+        if (grid.contains(point.x(), point.y())) {
+          objectsInbound.insert(point.m_id);
         }
       }
       hasObjectsInbound = objectsInbound.size() > 0;
@@ -173,11 +175,15 @@ TEST(GridTests, TrackMultiplePointsMultiThreaded) {
       points.push_back(createPoint(i, grid, nCellWidth / 5.0));
     }
 
+    // Workers only look for new cells, while cells are updated by the main
+    // thread (the same way as NewtonEngine does)
+    std::vector<Cell*> newCells(points.size(), nullptr);
+
     boost::fibers::barrier barrier(totalThread + 1);
     std::atomic_size_t     idx;
     bool                   continueFlag = true;
 
-    auto worker = [&barrier, &points, &idx, &continueFlag] () {
+    auto worker = [&barrier, &points, &newCells, &idx, &continueFlag] () {
       const size_t batch = 16;
       while (true) {
         barrier.wait();
@@ -190,10 +196,8 @@ TEST(GridTests, TrackMultiplePointsMultiThreaded) {
           for (size_t objectId = begin; objectId < end; ++objectId) {
             Point& point = points[objectId];
             point.m_position += point.m_velocity;
-            if (point.m_pCell) {
-              point.m_pCell = point.m_pCell->track(
-                    point.m_id, point.x(), point.y());
-            }
+            newCells[objectId] =
+                point.m_pCell->destination(point.x(), point.y());
           }
         }
         barrier.wait();
@@ -214,8 +218,17 @@ TEST(GridTests, TrackMultiplePointsMultiThreaded) {
       barrier.wait();
 
       std::set<uint32_t> objectsInbound;
-      for (const Point& point: points) {
-        if (point.m_pCell) {
+      for (Point& point: points) {
+        Cell* pNewCell = newCells[point.m_id];
+        if (!pNewCell) {
+          // Outer cell should be created
+          pNewCell = grid.obtainCell(point.x(), point.y());
+        }
+        if (point.m_pCell != pNewCell) {
+          grid.move(point.m_id, point.m_pCell, pNewCell);
+        }
+        point.m_pCell = pNewCell;
+        if (grid.contains(point.x(), point.y())) {
           objectsInbound.insert(point.m_id);
         }
       }
@@ -294,4 +307,236 @@ TEST(GridTests, CellIterator) {
   }
 }
 
+TEST(GridTests, OuterCells) {
+  const uint32_t nCellWidth = 1000;
+  Grid grid(8, nCellWidth);  // Core is 8000 x 8000
+
+  // Outer cells are created only when objects get there
+  ASSERT_EQ(nullptr, grid.getCell(1e9, -1e12));
+  Cell* pFarCell = grid.add(0, 1e9, -1e12);
+  ASSERT_TRUE(pFarCell);
+  ASSERT_EQ(pFarCell, grid.getCell(1e9, -1e12));
+  ASSERT_TRUE(pFarCell->contains(1e9, -1e12));
+  ASSERT_EQ(uint64_t(8000), pFarCell->width());
+  ASSERT_TRUE(pFarCell->getObjects().has(0));
+
+  // Neighbor of the core
+  Cell* pNearCell = grid.add(1, 4000, -4001);
+  ASSERT_TRUE(pNearCell);
+  ASSERT_EQ(4000, pNearCell->left());
+  ASSERT_EQ(-4000, pNearCell->top());
+  ASSERT_EQ(size_t(2), grid.outerCells().size());
+
+  // Objects beyond the bounds are not indexed
+  ASSERT_EQ(nullptr, grid.add(2, 1e20, 0.0));
+
+  // Moving object between outer cells
+  pNearCell = pNearCell->track(1, 1e9 + 1, -1e12 + 1);
+  ASSERT_EQ(pFarCell, pNearCell);
+  ASSERT_TRUE(pFarCell->getObjects().has(1));
+  ASSERT_EQ(size_t(0), grid.outerCells()[1].getObjects().size());
+
+  // Moving object to the core
+  Cell* pCoreCell = pFarCell->track(0, 10.0, 10.0);
+  ASSERT_EQ(grid.getCell(10, 10), pCoreCell);
+  ASSERT_TRUE(pCoreCell->getObjects().has(0));
+  ASSERT_FALSE(pFarCell->getObjects().has(0));
+
+  // Check that 'range()' iterates through outer cells as well as through
+  // the cells of the core
+  const geometry::Rectangle arena(geometry::Point(-1e6, 1e6),
+                                  geometry::Point(1e6, -1e6));
+  for (uint32_t i = 0; i < 200; ++i) {
+    utils::Randomizer::setPattern(i);
+    geometry::Point position;
+    utils::Randomizer::yield(position, arena);
+    grid.add(100 + i, position.x, position.y);
+  }
+
+  for (uint32_t i = 0; i < 1000; ++i) {
+    utils::Randomizer::setPattern(i);
+
+    geometry::Rectangle rect;
+    utils::Randomizer::yield(rect, arena.extend(1.4));
+
+    std::set<const Cell*> iteratedCells;
+    Grid::iterator I = grid.range(
+          rect.left(), rect.bottom(), rect.width(), rect.height());
+    for(Grid::iterator end = grid.end(); I != end; ++I) {
+      const Cell& cell = *I;
+      ASSERT_TRUE(hasIntersections(cell, rect)) << "Iteration #" << i;
+      ASSERT_TRUE(iteratedCells.insert(&cell).second) << "Iteration #" << i;
+    }
+
+    std::set<const Cell*> expectedCells;
+    for (const Cell& cell: grid) {
+      if (hasIntersections(cell, rect)) {
+        expectedCells.insert(&cell);
+      }
+    }
+    ASSERT_EQ(expectedCells, iteratedCells) << "Iteration #" << i;
+  }
+}
+
+TEST(GridTests, CellVersion) {
+  Grid grid(8, 1000);
+  Cell* pCell  = grid.getCell(10, 10);
+  Cell* pOther = grid.getCell(1500, 10);
+  const uint32_t nVersion      = pCell->getVersion();
+  const uint32_t nOtherVersion = pOther->getVersion();
+
+  // Version is changed when object enters or leaves the cell
+  pCell->add(1, 10, 10);
+  ASSERT_NE(nVersion, pCell->getVersion());
+
+  // ... but not when object moves inside the cell
+  const uint32_t nVersionWithObject = pCell->getVersion();
+  ASSERT_EQ(pCell, pCell->track(1, 900, 900));
+  ASSERT_EQ(nVersionWithObject, pCell->getVersion());
+
+  ASSERT_EQ(pOther, pCell->track(1, 1500, 10));
+  ASSERT_NE(nVersionWithObject, pCell->getVersion());
+  ASSERT_NE(nOtherVersion, pOther->getVersion());
+}
+
+TEST(GridTests, ObjectsTypes) {
+  Grid grid(8, 1000);
+  Cell* pCell  = grid.getCell(10, 10);
+  Cell* pOther = grid.getCell(1500, 10);
+
+  pCell->add(1, 10, 10, ObjectType::eAsteroid);
+  pCell->add(2, 20, 20, ObjectType::eShip);
+  pCell->add(3, 30, 30, ObjectType::eAsteroid);
+  ASSERT_EQ(2, pCell->countObjects(ObjectType::eAsteroid));
+  ASSERT_EQ(1, pCell->countObjects(ObjectType::eShip));
+
+  // Type tags are kept at the same indexes as objects ids
+  auto checkTags = [](const Cell* pCell) {
+    const utils::UnorderedVector<uint32_t>& objects = pCell->getObjects();
+    for (size_t i = 0; i < objects.size(); ++i) {
+      const ObjectType eExpected =
+          objects[i] == 2 ? ObjectType::eShip : ObjectType::eAsteroid;
+      ASSERT_EQ(eExpected, pCell->getObjectType(i));
+    }
+  };
+
+  // Object keeps it's type, when it moves to another cell
+  ASSERT_EQ(pOther, pCell->track(1, 1500, 10));
+  checkTags(pCell);
+  checkTags(pOther);
+  ASSERT_EQ(1, pCell->countObjects(ObjectType::eAsteroid));
+  ASSERT_EQ(1, pOther->countObjects(ObjectType::eAsteroid));
+
+  grid.move(2, pCell, nullptr);
+  checkTags(pCell);
+  ASSERT_EQ(0, pCell->countObjects(ObjectType::eShip));
+  ASSERT_EQ(1, pCell->getObjects().size());
+}
+
+TEST(GridTests, SplitDenseCluster) {
+  Grid grid(10, 1024);  // Core is from -5120 to 5120
+  grid.setSplitThreshold(16);
+  Cell* pClusterCell = grid.getCell(10, 10);
+  ASSERT_EQ(0, pClusterCell->left());
+  ASSERT_EQ(0, pClusterCell->bottom());
+
+  // A dense cluster inside the single cell and a few scattered objects
+  utils::Randomizer::setPattern(17);
+  std::vector<geometry::Point> positions;
+  const geometry::Rectangle cluster(geometry::Point(0, 256),
+                                    geometry::Point(256, 0));
+  for (uint32_t i = 0; i < 300; ++i) {
+    geometry::Point position;
+    utils::Randomizer::yield(position, i < 200 ? cluster : grid.asRect());
+    positions.push_back(position);
+    grid.add(i, position.x, position.y,
+             i % 2 ? ObjectType::eAsteroid : ObjectType::eShip);
+  }
+  ASSERT_LT(16, pClusterCell->getObjects().size());
+
+  std::map<uint32_t, Cell*> relocated;
+  const size_t nSplit = grid.splitOverfilledCells(
+        [&positions](uint32_t nObjectId) { return positions[nObjectId]; },
+        [&relocated](uint32_t nObjectId, Cell* pNewCell) {
+          relocated[nObjectId] = pNewCell;
+        });
+  ASSERT_LT(0, nSplit);
+  ASSERT_TRUE(pClusterCell->isSplit());
+  ASSERT_EQ(0, pClusterCell->getObjects().size());
+  // Nothing is left to split
+  ASSERT_EQ(0, grid.splitOverfilledCells(
+              [&positions](uint32_t nObjectId) { return positions[nObjectId]; },
+              [](uint32_t, Cell*) {}));
+
+  // Every object is in the cell, that is returned by 'getCell()', and that
+  // cell is not overfilled, unless it can't be split anymore
+  for (uint32_t i = 0; i < positions.size(); ++i) {
+    const geometry::Point& position = positions[i];
+    Cell* pCell = grid.getCell(position.x, position.y);
+    ASSERT_TRUE(pCell);
+    ASSERT_FALSE(pCell->isSplit());
+    ASSERT_TRUE(pCell->contains(position.x, position.y));
+    ASSERT_TRUE(pCell->getObjects().has(i));
+    ASSERT_TRUE(pCell->getObjects().size() <= 16
+                || pCell->depth() == Grid::eMaxSplitDepth);
+    ASSERT_EQ(pCell, pClusterCell->destination(position.x, position.y));
+    if (pClusterCell->contains(position.x, position.y)) {
+      ASSERT_EQ(pCell, relocated.at(i));
+      ASSERT_LT(0, pCell->depth());
+    } else {
+      ASSERT_EQ(relocated.end(), relocated.find(i));
+    }
+  }
+
+  // Types of objects are kept
+  for (const Cell& cell: grid) {
+    const utils::UnorderedVector<uint32_t>& objects = cell.getObjects();
+    for (size_t i = 0; i < objects.size(); ++i) {
+      const ObjectType eExpected =
+          objects[i] % 2 ? ObjectType::eAsteroid : ObjectType::eShip;
+      ASSERT_EQ(eExpected, cell.getObjectType(i));
+    }
+  }
+
+  // Objects move between children of the split cell
+  Cell* pFrom = grid.getCell(positions[0].x, positions[0].y);
+  Cell* pTo   = pFrom->track(0, 1000.0, 1000.0);
+  ASSERT_EQ(grid.getCell(1000, 1000), pTo);
+  ASSERT_NE(pFrom, pTo);
+  ASSERT_TRUE(pTo->getObjects().has(0));
+
+  // 'range()' returns children of split cells, and a small area inside the
+  // cluster is covered by a few small cells
+  for (uint32_t i = 0; i < 1000; ++i) {
+    utils::Randomizer::setPattern(i);
+
+    geometry::Rectangle rect;
+    utils::Randomizer::yield(rect, grid.asRect());
+
+    std::set<const Cell*> iteratedCells;
+    Grid::iterator I = grid.range(
+          rect.left(), rect.bottom(), rect.width(), rect.height());
+    for(Grid::iterator end = grid.end(); I != end; ++I) {
+      const Cell& cell = *I;
+      ASSERT_TRUE(hasIntersections(cell, rect)) << "Iteration #" << i;
+      ASSERT_TRUE(iteratedCells.insert(&cell).second) << "Iteration #" << i;
+    }
+
+    std::set<const Cell*> expectedCells;
+    for (const Cell& cell: grid) {
+      if (hasIntersections(cell, rect)) {
+        expectedCells.insert(&cell);
+      }
+    }
+    ASSERT_EQ(expectedCells, iteratedCells) << "Iteration #" << i;
+  }
+
+  // Without splitting all 200 objects of the cluster would be checked
+  size_t nChecked = 0;
+  for (Grid::iterator I = grid.range(100, 100, 20, 20); I != grid.end(); ++I) {
+    nChecked += I->getObjects().size();
+  }
+  ASSERT_GT(size_t(50), nChecked);
+}
+
 }  // namespace world
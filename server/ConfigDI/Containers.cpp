@@ -75,7 +75,8 @@ AdministratorCfg& AdministratorCfg::setPassord(std::string sPassword)
 //==============================================================================
 
 ApplicationCfg::ApplicationCfg()
-  : m_nTotalThreads(1), m_nLoginUdpPort(0xFFFF)
+  : m_nTotalThreads(1), m_nLoginUdpPort(0xFFFF), m_lWorkStealingConveyor(false),
+    m_lNetworkIoThread(false), m_lMessagesCoalescing(false)
 {}
 
 ApplicationCfg::ApplicationCfg(IApplicationCfg const& other)
@@ -85,6 +86,9 @@ ApplicationCfg::ApplicationCfg(IApplicationCfg const& other)
     m_portsPool(other.getPortsPoolcfg()),
     m_globalGrid(other.getGlobalGridCfg()),
     m_lIsClockFreezed(other.isClockFreezed()),
+    m_lWorkStealingConveyor(other.isWorkStealingConveyor()),
+    m_lNetworkIoThread(other.isNetworkIoThread()),
+    m_lMessagesCoalescing(other.isMessagesCoalescing()),
     m_administratorCfg(other.getAdministratorCfg())
 {}
 
@@ -124,4 +128,22 @@ ApplicationCfg &ApplicationCfg::setClockInitialState(bool lFreezed)
   return *this;
 }
 
+ApplicationCfg &ApplicationCfg::setWorkStealingConveyor(bool lEnabled)
+{
+  m_lWorkStealingConveyor = lEnabled;
+  return *this;
+}
+
+ApplicationCfg &ApplicationCfg::setNetworkIoThread(bool lEnabled)
+{
+  m_lNetworkIoThread = lEnabled;
+  return *this;
+}
+
+ApplicationCfg &ApplicationCfg::setMessagesCoalescing(bool lEnabled)
+{
+  m_lMessagesCoalescing = lEnabled;
+  return *this;
+}
+
 } // namespace config
@@ -141,6 +141,9 @@ public:
   ApplicationCfg& setGlobalGrid(IGlobalGridCfg const& cfg);
   ApplicationCfg& setAdministratorCfg(IAdministratorCfg const& cfg);
   ApplicationCfg& setClockInitialState(bool lFreezed);
+  ApplicationCfg& setWorkStealingConveyor(bool lEnabled);
+  ApplicationCfg& setNetworkIoThread(bool lEnabled);
+  ApplicationCfg& setMessagesCoalescing(bool lEnabled);
 
   // IApplicationCfg interface
   uint16_t              getTotalThreads()  const override { return m_nTotalThreads; }
@@ -149,6 +152,9 @@ public:
   IPortsPoolCfg const&  getPortsPoolcfg()  const override { return m_portsPool; }
   IGlobalGridCfg const& getGlobalGridCfg() const override { return m_globalGrid; }
   bool                  isClockFreezed()   const override { return m_lIsClockFreezed; }
+  bool isWorkStealingConveyor() const override { return m_lWorkStealingConveyor; }
+  bool isNetworkIoThread()      const override { return m_lNetworkIoThread; }
+  bool isMessagesCoalescing()   const override { return m_lMessagesCoalescing; }
   AdministratorCfg const& getAdministratorCfg() const override {
     return m_administratorCfg;
   }
@@ -160,6 +166,9 @@ private:
   PortsPoolCfg     m_portsPool;
   GlobalGridCfg    m_globalGrid;
   bool             m_lIsClockFreezed;
+  bool             m_lWorkStealingConveyor;
+  bool             m_lNetworkIoThread;
+  bool             m_lMessagesCoalescing;
   AdministratorCfg m_administratorCfg;
 };
 
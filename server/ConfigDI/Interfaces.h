@@ -46,6 +46,9 @@ public:
   virtual IAdministratorCfg const& getAdministratorCfg() const = 0;
   virtual IGlobalGridCfg    const& getGlobalGridCfg()    const = 0;
   virtual bool                     isClockFreezed()      const = 0;
+  virtual bool                     isWorkStealingConveyor() const = 0;
+  virtual bool                     isNetworkIoThread()   const = 0;
+  virtual bool                     isMessagesCoalescing() const = 0;
 };
 
 } // namespace config
@@ -69,12 +69,23 @@ ApplicationCfg ApplicationCfgReader::read(YAML::Node const& data)
 
   bool isClockFreezed = sInitialState == "freezed";
 
+  // Optional parameter
+  std::string sConveyorMode = "lockstep";
+  utils::YamlReader(data).read("conveyor-mode", sConveyorMode);
+  std::string sNetworkMode = "conveyor";
+  utils::YamlReader(data).read("network-mode", sNetworkMode);
+  std::string sCoalescing = "off";
+  utils::YamlReader(data).read("coalescing", sCoalescing);
+
   return ApplicationCfg()
       .setLoginUdpPort(nLoginUdpPort)
       .setTotalThreads(nTotalThreads)
       .setAdministratorCfg(
         AdministratorCfgReader::read(data["administrator"]))
       .setClockInitialState(isClockFreezed)
+      .setWorkStealingConveyor(sConveyorMode == "work-stealing")
+      .setNetworkIoThread(sNetworkMode == "io-thread")
+      .setMessagesCoalescing(sCoalescing == "on")
       .setPortsPool(
         PortsPoolCfgReader::read(data["ports-pool"]))
       .setGlobalGrid(
@@ -25,8 +25,9 @@ public:
 // Conveyor
 //========================================================================================
 
-Conveyor::Conveyor(uint16_t nTotalNumberOfThreads)
-  : m_Barrier(nTotalNumberOfThreads)
+Conveyor::Conveyor(uint16_t nTotalNumberOfThreads, Mode eMode)
+  : m_eMode(eMode)
+  , m_Barrier(nTotalNumberOfThreads)
 {}
 
 Conveyor::~Conveyor()
@@ -36,15 +37,30 @@ Conveyor::~Conveyor()
 
 void Conveyor::addLogicToChain(IAbstractLogicPtr pLogic)
 {
-  LogicContext context;
+  LogicContext& context = m_LogicChain.emplace_back();
   context.m_pLogic             = pLogic;
+  context.m_access             = pLogic->getDataAccess();
   context.m_nLastProceedAt     = m_State.nCurrentTimeUs;
   context.m_nDoNotDisturbUntil = 0;
-  m_LogicChain.push_back(std::move(context));
+
+  // The logic depends on every previous logic it conflicts with. Since the
+  // last element is the new logic itself, it should be skipped
+  for (size_t i = 0; i + 1 < m_LogicChain.size(); ++i) {
+    LogicContext& dependency = m_LogicChain[i];
+    if (dependency.m_access.conflictsWith(context.m_access)) {
+      dependency.m_successors.push_back(&context);
+      ++context.m_nTotalDependencies;
+    }
+  }
 }
 
 void Conveyor::proceed(uint32_t nIntervalUs)
 {
+  if (m_eMode == Mode::eWorkStealing) {
+    proceedAsTasks(nIntervalUs);
+    return;
+  }
+
   m_now                  += nIntervalUs;
   m_State.nCurrentTimeUs += nIntervalUs;
   m_State.pSelectedLogic = nullptr;
@@ -76,6 +92,21 @@ void Conveyor::proceed(uint32_t nIntervalUs)
 
 void Conveyor::joinAsSlave()
 {
+  if (m_eMode == Mode::eWorkStealing) {
+    const size_t nThreadId = m_nNextThreadId.fetch_add(1);
+    while (true) {
+      m_Barrier.wait();
+      const bool lTerminating = m_lTerminating;
+      if (!lTerminating) {
+        runTasks(nThreadId);
+      }
+      m_Barrier.wait();
+      if (lTerminating) {
+        return;
+      }
+    }
+  }
+
   gContinueSlave = true;
   while (gContinueSlave) {
     m_Barrier.wait();
@@ -87,8 +118,14 @@ void Conveyor::joinAsSlave()
 
 void Conveyor::stop()
 {
+  if (m_lStopped) {
+    return;
+  }
+  m_lStopped = true;
+
   SlaveTerminator terminator;
   m_State.pSelectedLogic = &terminator;
+  m_lTerminating         = true;
   m_Barrier.wait();
   // all slave threads will set gContinueSlave to false and after next barrier
   // they will quit from Conveyor::joinAsSlave() function
@@ -96,4 +133,132 @@ void Conveyor::stop()
   std::this_thread::yield();  // for sure
 }
 
+//========================================================================================
+// Conveyor: work-stealing mode
+//========================================================================================
+
+// Is set in 'LogicContext::m_nTaskState' while new threads may join the
+// current stage of the logic. The rest bits are used as a counter of threads,
+// that are proceeding the stage right now.
+static const uint32_t eTaskOpened = 0x80000000;
+
+void Conveyor::proceedAsTasks(uint32_t nIntervalUs)
+{
+  // Prephare a plan of the tick. Since all slave threads are waiting on the
+  // barrier, no synchronization is required here.
+  m_now                  += nIntervalUs;
+  m_State.nCurrentTimeUs += nIntervalUs;
+  m_nTickIntervalUs       = nIntervalUs;
+  m_nLogicsLeft.store(m_LogicChain.size());
+
+  for (LogicContext& context : m_LogicChain) {
+    context.m_lShouldProceed =
+        m_State.nCurrentTimeUs >= context.m_nDoNotDisturbUntil;
+    context.m_nLastIntervalUs = static_cast<uint32_t>(
+          m_State.nCurrentTimeUs - context.m_nLastProceedAt);
+    context.m_nPendingDependencies.store(context.m_nTotalDependencies);
+    context.m_nTaskState.store(0);
+  }
+
+  for (LogicContext& context : m_LogicChain) {
+    if (!context.m_nTotalDependencies) {
+      activate(context);
+    }
+  }
+
+  if (m_nLogicsLeft.load() == 0) {
+    // There is nothing to do for slaves on this tick
+    return;
+  }
+  m_Barrier.wait();
+  runTasks(0);
+  m_Barrier.wait();
+}
+
+void Conveyor::runTasks(size_t nThreadId)
+{
+  const size_t nTotalLogics = m_LogicChain.size();
+  // Each thread starts looking for a task from it's own position, so threads
+  // tend to be spread between logics, that are ready to be proceeded
+  const size_t nOffset = nTotalLogics ? nThreadId % nTotalLogics : 0;
+
+  while (m_nLogicsLeft.load(std::memory_order_acquire)) {
+    bool lTaskFound = false;
+    for (size_t i = 0; i < nTotalLogics; ++i) {
+      LogicContext& context = m_LogicChain[(nOffset + i) % nTotalLogics];
+      if (!tryToJoin(context)) {
+        continue;
+      }
+      context.m_pLogic->proceed(
+            context.m_nStageId, context.m_nLastIntervalUs, m_now);
+      leave(context);
+      lTaskFound = true;
+      break;
+    }
+    if (!lTaskFound) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+bool Conveyor::tryToJoin(LogicContext& context)
+{
+  uint32_t nState = context.m_nTaskState.load(std::memory_order_acquire);
+  while (nState & eTaskOpened) {
+    if (context.m_nTaskState.compare_exchange_weak(
+          nState, nState + 1, std::memory_order_acq_rel)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void Conveyor::leave(LogicContext& context)
+{
+  // Since proceed() has returned, all the work of the stage has been already
+  // taken by some threads, so there is no reason for other threads to join it
+  context.m_nTaskState.fetch_and(~eTaskOpened, std::memory_order_acq_rel);
+  if (context.m_nTaskState.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    // The last thread has left the stage, so the logic belongs to this thread
+    // until the next stage is opened
+    switchToStage(context, context.m_nStageId + 1);
+  }
+}
+
+void Conveyor::activate(LogicContext& context)
+{
+  if (context.m_lShouldProceed) {
+    switchToStage(context, 0);
+  } else {
+    onFinished(context);
+  }
+}
+
+void Conveyor::switchToStage(LogicContext& context, uint16_t nStageId)
+{
+  IAbstractLogic* pLogic       = context.m_pLogic.get();
+  const uint16_t  nTotalStages = pLogic->getStagesCount();
+  for (; nStageId < nTotalStages; ++nStageId) {
+    if (pLogic->prephare(nStageId, m_nTickIntervalUs, m_now)) {
+      context.m_nStageId = nStageId;
+      context.m_nTaskState.store(eTaskOpened, std::memory_order_release);
+      return;
+    }
+  }
+  context.m_nDoNotDisturbUntil += pLogic->getCooldownTimeUs();
+  context.m_nLastProceedAt      = m_State.nCurrentTimeUs;
+  onFinished(context);
+}
+
+void Conveyor::onFinished(LogicContext& context)
+{
+  for (LogicContext* pSuccessor : context.m_successors) {
+    if (pSuccessor->m_nPendingDependencies.fetch_sub(
+          1, std::memory_order_acq_rel) == 1) {
+      activate(*pSuccessor);
+    }
+  }
+  m_nLogicsLeft.fetch_sub(1, std::memory_order_acq_rel);
+}
+
 } // namespace conveoyr
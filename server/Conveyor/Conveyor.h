@@ -2,6 +2,8 @@
 
 #include "IAbstractLogic.h"
 #include <vector>
+#include <deque>
+#include <atomic>
 #include <boost/fiber/barrier.hpp>
 
 namespace conveyor
@@ -10,10 +12,27 @@ namespace conveyor
 class Conveyor
 {
 public:
-  Conveyor(uint16_t nTotalNumberOfThreads);
+  enum class Mode {
+    eLockstep,
+      // All threads proceed the same stage of the same logic. Threads are
+      // synchronized by a barrier before and after each stage.
+    eWorkStealing
+      // Each stage is submitted as a task, that can be picked up by any idle
+      // thread. Logics, that don't depend on each other, are proceeded
+      // concurrently. Threads are synchronized by a barrier only at the
+      // beginning and at the end of the tick.
+  };
+
+  Conveyor(uint16_t nTotalNumberOfThreads, Mode eMode = Mode::eLockstep);
   ~Conveyor();
 
   void addLogicToChain(IAbstractLogicPtr pLogic);
+    // Add the specified 'pLogic' to the end of the chain. In work-stealing
+    // mode the logic will be proceeded as soon as all previous logics, that
+    // conflict with it (see IAbstractLogic::getDataAccess()), have been
+    // proceeded. In lockstep mode logics are proceeded in the chain's order.
+
+  Mode getMode() const { return m_eMode; }
 
   void proceed(uint32_t nIntervalUs);
   void joinAsSlave();
@@ -24,14 +43,39 @@ private:
   struct LogicContext
   {
     IAbstractLogicPtr m_pLogic;
+    DataAccess        m_access;
     size_t            m_nDoNotDisturbUntil;
     size_t            m_nLastProceedAt;
+
+    // Work-stealing mode only:
+    std::vector<LogicContext*> m_successors;
+      // Logics, that can't be started until this logic is finished
+    uint32_t              m_nTotalDependencies = 0;
+    std::atomic<uint32_t> m_nPendingDependencies = 0;
+      // How many logics should be finished before this logic can be started
+    std::atomic<uint32_t> m_nTaskState = 0;
+      // Contains 'eTaskOpened' flag and a number of threads, that are
+      // proceeding the current stage of the logic right now
+    uint16_t              m_nStageId        = 0;
+    uint32_t              m_nLastIntervalUs = 0;
+    bool                  m_lShouldProceed  = false;
   };
 
+  // Work-stealing mode:
+  void proceedAsTasks(uint32_t nIntervalUs);
+  void runTasks(size_t nThreadId);
+  bool tryToJoin(LogicContext& context);
+  void leave(LogicContext& context);
+  void activate(LogicContext& context);
+  void switchToStage(LogicContext& context, uint16_t nStageId);
+  void onFinished(LogicContext& context);
+
 private:
+  Mode                      m_eMode;
   boost::fibers::barrier    m_Barrier;
-  std::vector<LogicContext> m_LogicChain;
+  std::deque<LogicContext>  m_LogicChain;
   uint64_t                  m_now         = 0;
+  bool                      m_lStopped    = false;
 
   struct State
   {
@@ -40,6 +84,12 @@ private:
     uint16_t        nStageId        = 0;
     size_t          nLastIntervalUs = 0;
   } m_State;
+
+  // Work-stealing mode:
+  uint32_t                   m_nTickIntervalUs = 0;
+  std::atomic<size_t>        m_nLogicsLeft     = 0;
+  std::atomic<size_t>        m_nNextThreadId   = 1;
+  bool                       m_lTerminating    = false;
 };
 
 } // namespace conveoyr
@@ -6,9 +6,52 @@
 
 namespace conveyor {
 
+// Data, shared between logics. Is used by conveyor in work-stealing mode to
+// find out, which logics may be proceeded concurrently.
+enum SharedData : uint32_t {
+  eNoData          = 0,
+  ePhysics         = 1 << 0,
+    // Positions, velocities and masses of physical objects
+  eObjectsRegistry = 1 << 1,
+    // Global containers of objects (creating and destroying objects)
+  eResources       = 1 << 2,
+    // Resources, stored in containers and asteroids
+  ePlayers         = 1 << 3,
+    // Players storage and players' properties
+  eSessions        = 1 << 4,
+    // Sessions and channels (opening and closing sessions)
+  eInbox           = 1 << 5,
+    // Buffered incoming messages of terminals
+  eFilters         = 1 << 6,
+    // Results of objects filters (see tools::ObjectsFilteringManager)
+  eAllData         = 0xFFFFFFFF
+};
+
+// Describes, which data a logic reads and which data it writes. Logics, that
+// only read the same data (or work with different data), don't conflict with
+// each other.
+struct DataAccess
+{
+  DataAccess(uint32_t nReads = eAllData, uint32_t nWrites = eAllData)
+    : m_nReads(nReads), m_nWrites(nWrites)
+  {}
+
+  bool conflictsWith(DataAccess const& other) const {
+    return (m_nWrites & (other.m_nReads | other.m_nWrites))
+        || (other.m_nWrites & m_nReads);
+  }
+
+  uint32_t m_nReads;
+  uint32_t m_nWrites;
+};
+
 // Functions getStagesCount() and prephareStage() will be called in main thread and they
 // don't need to be thread safe.
 // Function proceedStage() could be called in several threads and must be thread safe.
+// NOTE: in work-stealing mode (see Conveyor::Mode) prephare() may be called from any
+// thread, but it is never called concurrently with any other call of the same logic.
+// Also proceed() may be called by only some of the threads, so once any thread returns
+// from proceed(), all the work of the stage should be already taken by threads.
 class IAbstractLogic
 {
 public:
@@ -37,6 +80,13 @@ public:
   // NOTE: By default, logic won't be proceeded more than 100 times per second
   // NOTE: in-game time can differ from real time
   virtual size_t getCooldownTimeUs() const { return 10 * 1000; }
+
+  // Return data, that is read and written by the logic. A logic will be
+  // proceeded only when all previously added logics, that conflict with it,
+  // have been proceeded.
+  // NOTE: By default, logic reads and writes everything, so it can't be
+  // proceeded concurrently with any other logic
+  virtual DataAccess getDataAccess() const { return DataAccess(); }
 };
 
 using IAbstractLogicPtr = std::shared_ptr<IAbstractLogic>;
@@ -77,6 +77,10 @@ public:
   bool prephare(uint16_t nStageId, uint32_t nIntervalUs, uint64_t now) override;
   void proceed(uint16_t nStageId, uint32_t nIntervalUs, uint64_t now) override;
   size_t getCooldownTimeUs() const override { return 0; }
+  conveyor::DataAccess getDataAccess() const override {
+    return conveyor::DataAccess(conveyor::ePhysics | conveyor::eObjectsRegistry,
+                                conveyor::eFilters);
+  }
 
 private:
   std::vector<BaseObjectFilterWeakPtr> m_filters;
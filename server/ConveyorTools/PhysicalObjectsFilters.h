@@ -1,7 +1,11 @@
 #include "ObjectsFilter.h"
 
+#include <algorithm>
+#include <mutex>
+
 #include <Geometry/Rectangle.h>
 #include <Newton/PhysicalObject.h>
+#include <World/Grid.h>
 
 // This file contains a number of filters, that can be used to select physical
 // objects (by it's position or signature or smth)
@@ -24,53 +28,134 @@ public:
   void reset() override
   {
     m_filteredInstances.clear();
+    m_lUseGrid = collectCandidateCells();
   }
 
   void proceed() override
+  {
+    if (m_lUseGrid) {
+      proceedCandidateCells();
+    } else {
+      proceedAllObjects();
+    }
+  }
+
+  // Return array of filtered objects
+  std::vector<newton::PhysicalObject*> const& getFiltered() const {
+    return m_filteredInstances;
+  }
+
+protected:
+  virtual bool filter(newton::PhysicalObject const* pObj) = 0;
+
+  virtual bool getBoundingRect(geometry::Rectangle&) const { return false; }
+    // Write to the specified rectangle an area, that covers all objects,
+    // that may pass the filter. Return false, if there is no such area, so
+    // all objects should be checked.
+
+private:
+  using Buffer = std::array<newton::PhysicalObject*, 64>;
+
+  bool collectCandidateCells()
+  {
+    // Called in a single thread (see 'reset()'), so it is safe to fill
+    // 'm_candidateCells' here
+    m_candidateCells.clear();
+    const world::Grid*  pGrid = world::Grid::getGlobal();
+    geometry::Rectangle area;
+    if (!pGrid || !m_pObjectsContainer || !getBoundingRect(area)) {
+      return false;
+    }
+
+    // Objects are stored in cells by their centers
+    const double nMargin = newton::PhysicsStorage::instance().maxRadius();
+    const size_t nTotalObjects = m_pObjectsContainer->getObjects().size();
+
+    size_t nCellsChecked = 0;
+    world::Grid::iterator itCell = pGrid->range(
+          area.left() - nMargin,
+          area.bottom() - nMargin,
+          std::max(area.width() + 2 * nMargin, 1.0),
+          std::max(area.height() + 2 * nMargin, 1.0));
+    for (world::Grid::iterator end = pGrid->end(); itCell != end; ++itCell) {
+      if (++nCellsChecked > nTotalObjects) {
+        // Area is too large, so full scan is cheaper
+        m_candidateCells.clear();
+        return false;
+      }
+      if (itCell->getObjects().size()) {
+        m_candidateCells.push_back(&*itCell);
+      }
+    }
+    return true;
+  }
+
+  void proceedAllObjects()
   {
     std::vector<newton::PhysicalObject*> const& objects =
         m_pObjectsContainer->getObjects();
 
-    std::array<newton::PhysicalObject*, 64> buffer;
+    Buffer buffer;
     size_t nElementsInBuffer = 0;
 
     for (uint32_t nObjectId = yieldId();
          nObjectId < objects.size();
          nObjectId = yieldId()) {
       newton::PhysicalObject* pObj = objects[nObjectId];
-      if (!pObj || !filter(pObj)) {
-        continue;
+      if (pObj && filter(pObj)) {
+        pushToBuffer(buffer, nElementsInBuffer, pObj);
       }
+    }
+    flushBuffer(buffer, nElementsInBuffer);
+  }
+
+  void proceedCandidateCells()
+  {
+    Buffer buffer;
+    size_t nElementsInBuffer = 0;
 
-      buffer[nElementsInBuffer++] = pObj;
-      if (nElementsInBuffer == buffer.size()) {
-        std::lock_guard<std::mutex> guard(m_mutex);
-        m_filteredInstances.insert(m_filteredInstances.end(),
-                                   buffer.begin(), buffer.end());
-        nElementsInBuffer = 0;
+    for (uint32_t nCellId = yieldId();
+         nCellId < m_candidateCells.size();
+         nCellId = yieldId()) {
+      for (uint32_t nObjectId: m_candidateCells[nCellId]->getObjects().data()) {
+        newton::PhysicalObject* pObj =
+            utils::GlobalContainer<newton::PhysicalObject>::Instance(nObjectId);
+        if (pObj && m_pObjectsContainer->contains(pObj) && filter(pObj)) {
+          pushToBuffer(buffer, nElementsInBuffer, pObj);
+        }
       }
     }
+    flushBuffer(buffer, nElementsInBuffer);
+  }
+
+  void pushToBuffer(Buffer& buffer, size_t& nElementsInBuffer,
+                    newton::PhysicalObject* pObj)
+  {
+    buffer[nElementsInBuffer++] = pObj;
+    if (nElementsInBuffer == buffer.size()) {
+      flushBuffer(buffer, nElementsInBuffer);
+    }
+  }
 
+  void flushBuffer(Buffer const& buffer, size_t& nElementsInBuffer)
+  {
     if (nElementsInBuffer) {
       std::lock_guard<std::mutex> guard(m_mutex);
       m_filteredInstances.insert(m_filteredInstances.end(),
                                  buffer.begin(),
                                  buffer.begin() + nElementsInBuffer);
+      nElementsInBuffer = 0;
     }
   }
 
-  // Return array of filtered objects
-  std::vector<newton::PhysicalObject*> const& getFiltered() const {
-    return m_filteredInstances;
-  }
-
-protected:
-  virtual bool filter(newton::PhysicalObject const* pObj) = 0;
-
 private:
   std::mutex m_mutex;
   std::vector<newton::PhysicalObject*>               m_filteredInstances;
   utils::ObjectsContainerPtr<newton::PhysicalObject> m_pObjectsContainer;
+
+  bool                            m_lUseGrid = false;
+  std::vector<const world::Cell*> m_candidateCells;
+    // Cells of the global grid, that cover filter's area (if grid is used)
 };
 
 
@@ -95,10 +180,79 @@ protected:
     return m_rectangle.isCoveredByCircle(pObj->getPosition(), pObj->getRadius());
   }
 
+  bool getBoundingRect(geometry::Rectangle& rect) const override
+  {
+    rect = m_rectangle;
+    return true;
+  }
+
 private:
   geometry::Rectangle m_rectangle;
 };
 
 using RectangeFilterPtr = std::shared_ptr<RectangeFilter>;
 
+
+// This filter checks, that some physical object is at least partially
+// covered by a ring with the specified 'center', 'innerRadius' and
+// 'outerRadius'. Circle is a ring with zero inner radius.
+class RingFilter : public PysicalObjectsFilter
+{
+public:
+  RingFilter() = default;
+  RingFilter(geometry::Point const& center,
+             double innerRadius, double outerRadius)
+    : m_center(center), m_innerRadius(innerRadius), m_outerRadius(outerRadius)
+  {
+    assert(innerRadius <= outerRadius);
+  }
+
+  void setPosition(geometry::Point const& center,
+                   double innerRadius, double outerRadius)
+  {
+    assert(innerRadius <= outerRadius);
+    m_center      = center;
+    m_innerRadius = innerRadius;
+    m_outerRadius = outerRadius;
+  }
+
+protected:
+  bool filter(newton::PhysicalObject const* pObj) override
+  {
+    const double distance = m_center.distance(pObj->getPosition());
+    return distance + pObj->getRadius() >= m_innerRadius
+        && distance - pObj->getRadius() < m_outerRadius;
+  }
+
+  bool getBoundingRect(geometry::Rectangle& rect) const override
+  {
+    rect = geometry::Rectangle(m_center, 2 * m_outerRadius, 2 * m_outerRadius);
+    return true;
+  }
+
+private:
+  geometry::Point m_center;
+  double          m_innerRadius = 0;
+  double          m_outerRadius = 0;
+};
+
+using RingFilterPtr = std::shared_ptr<RingFilter>;
+
+
+class CircleFilter : public RingFilter
+{
+public:
+  CircleFilter() = default;
+  CircleFilter(geometry::Point const& center, double radius)
+    : RingFilter(center, 0, radius)
+  {}
+
+  void setPosition(geometry::Point const& center, double radius)
+  {
+    RingFilter::setPosition(center, 0, radius);
+  }
+};
+
+using CircleFilterPtr = std::shared_ptr<CircleFilter>;
+
 } // namespace tools
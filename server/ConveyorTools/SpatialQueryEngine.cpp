@@ -0,0 +1,238 @@
+#include "SpatialQueryEngine.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include <Newton/PhysicsStorage.h>
+#include <World/Grid.h>
+#include <Utils/Clock.h>
+
+namespace tools {
+
+SpatialQueryEngine* SpatialQueryEngine::g_pGlobalEngine = nullptr;
+
+void SpatialQuery::requestAt(
+    uint64_t nWhenUs, uint32_t nCenterObjectId, double radius)
+{
+  m_eState          = ePending;
+  m_nRequestedAtUs  = nWhenUs;
+  m_nCenterObjectId = nCenterObjectId;
+  m_radius          = radius;
+}
+
+void SpatialQueryEngine::registerQuery(SpatialQueryPtr const& pQuery)
+{
+  std::lock_guard<utils::Mutex> guard(m_queriesMutex);
+  m_queries.push_back(pQuery);
+}
+
+bool SpatialQueryEngine::prephare(uint16_t nStageId, uint32_t, uint64_t)
+{
+  // Queries are scheduled by the ingame clock, so it is used here instead of
+  // the conveyor's time
+  const uint64_t now = utils::GlobalClock::now();
+  switch (nStageId) {
+    case eStageSearch:
+      return collectDueQueries(now);
+    case eStagePublish:
+      publishResults(now);
+      return false;
+    default:
+      return false;
+  }
+}
+
+void SpatialQueryEngine::proceed(uint16_t nStageId, uint32_t, uint64_t)
+{
+  if (nStageId == eStageSearch) {
+    searchInCells();
+  }
+}
+
+bool SpatialQueryEngine::collectDueQueries(uint64_t now)
+{
+  m_dueQueries.clear();
+  m_areas.clear();
+  m_cellQueries.clear();
+  m_stripes.clear();
+  m_runs.clear();
+  m_hits.clear();
+
+  const world::Grid* pGrid = world::Grid::getGlobal();
+  if (!pGrid) {
+    return false;
+  }
+  const newton::PhysicsStorage& storage = newton::PhysicsStorage::instance();
+
+  {
+    std::lock_guard<utils::Mutex> guard(m_queriesMutex);
+    for (size_t i = 0; i < m_queries.size();) {
+      SpatialQueryPtr pQuery = m_queries[i].lock();
+      if (!pQuery) {
+        // To remove element, just swap it with last element and than remove
+        // last element
+        std::swap(m_queries[i], m_queries.back());
+        m_queries.pop_back();
+        continue;
+      }
+      ++i;
+      if (pQuery->m_eState != SpatialQuery::ePending
+          || pQuery->m_nRequestedAtUs > now) {
+        continue;
+      }
+      const uint32_t nCenterId = pQuery->m_nCenterObjectId;
+      if (nCenterId >= storage.size() || !storage.alive[nCenterId]) {
+        pQuery->cancel();
+        continue;
+      }
+      const geometry::Point center = storage.getPosition(nCenterId);
+      m_areas.push_back(
+            Area{center.x, center.y, pQuery->m_radius * pQuery->m_radius});
+      m_dueQueries.push_back(std::move(pQuery));
+    }
+  }
+
+  for (uint32_t nQueryId = 0; nQueryId < m_dueQueries.size(); ++nQueryId) {
+    const Area&  area   = m_areas[nQueryId];
+    const double radius = m_dueQueries[nQueryId]->m_radius;
+    world::Grid::iterator itCell = pGrid->range(
+          area.x - radius, area.y - radius,
+          std::max(2 * radius, 1.0), std::max(2 * radius, 1.0));
+    for (world::Grid::iterator end = pGrid->end(); itCell != end; ++itCell) {
+      if (itCell->getObjects().size()) {
+        m_cellQueries.push_back(CellQuery{&*itCell, nQueryId});
+      }
+    }
+  }
+
+  if (m_cellQueries.empty()) {
+    // Nothing to search, but empty results will be published anyway
+    return false;
+  }
+
+  // Cells of the core are stored in a single vector, so sorting by address
+  // puts them in a row-by-row order
+  std::sort(m_cellQueries.begin(), m_cellQueries.end());
+
+  const size_t nCellsPerStripe = 8;
+  size_t       nCellsInStripe  = nCellsPerStripe;
+  for (size_t i = 0; i < m_cellQueries.size(); ++i) {
+    if (i && m_cellQueries[i].pCell == m_cellQueries[i - 1].pCell) {
+      continue;
+    }
+    if (nCellsInStripe == nCellsPerStripe) {
+      m_stripes.push_back(i);
+      nCellsInStripe = 0;
+    }
+    ++nCellsInStripe;
+  }
+  m_stripes.push_back(m_cellQueries.size());
+  m_nNextStripe.store(0);
+  return true;
+}
+
+void SpatialQueryEngine::searchInCells()
+{
+  const newton::PhysicsStorage& storage = newton::PhysicsStorage::instance();
+
+  struct Object {
+    uint32_t        nObjectId;
+    geometry::Point position;
+  };
+
+  std::vector<Object>   objects;
+  std::vector<HitsRun>  runs;
+  std::vector<uint32_t> hits;
+  for (size_t nStripe = m_nNextStripe.fetch_add(1);
+       nStripe + 1 < m_stripes.size();
+       nStripe = m_nNextStripe.fetch_add(1)) {
+    const size_t nEnd = m_stripes[nStripe + 1];
+    size_t       i    = m_stripes[nStripe];
+    while (i < nEnd) {
+      // All queries, that cover the cell, are in [i, nCellEnd) range
+      const world::Cell* pCell    = m_cellQueries[i].pCell;
+      size_t             nCellEnd = i + 1;
+      while (nCellEnd < nEnd && m_cellQueries[nCellEnd].pCell == pCell) {
+        ++nCellEnd;
+      }
+
+      // Every object of the cell is read once
+      objects.clear();
+      for (uint32_t nObjectId: pCell->getObjects().data()) {
+        if (nObjectId < storage.size() && storage.alive[nObjectId]) {
+          objects.push_back(Object{nObjectId, storage.getPosition(nObjectId)});
+        }
+      }
+
+      for (size_t j = i; j < nCellEnd; ++j) {
+        const uint32_t nQueryId = m_cellQueries[j].nQueryId;
+        const Area&    area     = m_areas[nQueryId];
+        const size_t   nBegin   = hits.size();
+        for (Object const& object: objects) {
+          const double dx = object.position.x - area.x;
+          const double dy = object.position.y - area.y;
+          if (dx * dx + dy * dy < area.radiusSqr) {
+            hits.push_back(object.nObjectId);
+          }
+        }
+        if (hits.size() != nBegin) {
+          runs.push_back(HitsRun{
+                           nQueryId, pCell, pCell->getVersion(),
+                           isCovered(*pCell, area),
+                           static_cast<uint32_t>(hits.size() - nBegin)});
+        }
+      }
+      i = nCellEnd;
+    }
+  }
+
+  if (!runs.empty()) {
+    std::lock_guard<utils::Mutex> guard(m_hitsMutex);
+    m_runs.insert(m_runs.end(), runs.begin(), runs.end());
+    m_hits.insert(m_hits.end(), hits.begin(), hits.end());
+  }
+}
+
+void SpatialQueryEngine::publishResults(uint64_t now)
+{
+  for (SpatialQueryPtr const& pQuery: m_dueQueries) {
+    pQuery->m_results.clear();
+    pQuery->m_cells.clear();
+  }
+  size_t nOffset = 0;
+  for (HitsRun const& run: m_runs) {
+    SpatialQuery& query = *m_dueQueries[run.nQueryId];
+    const uint32_t nBegin = static_cast<uint32_t>(query.m_results.size());
+    query.m_results.insert(query.m_results.end(),
+                           m_hits.begin() + nOffset,
+                           m_hits.begin() + nOffset + run.nTotal);
+    query.m_cells.push_back(SpatialQuery::CellHits{
+                              run.pCell, run.nVersion, run.lCovered,
+                              nBegin, nBegin + run.nTotal});
+    nOffset += run.nTotal;
+  }
+  for (SpatialQueryPtr const& pQuery: m_dueQueries) {
+    pQuery->m_eState        = SpatialQuery::eReady;
+    pQuery->m_nAnsweredAtUs = now;
+  }
+  m_dueQueries.clear();
+  m_runs.clear();
+  m_hits.clear();
+}
+
+bool SpatialQueryEngine::isCovered(const world::Cell& cell, const Area& area)
+{
+  // Cell is covered if all it's corners are inside the area
+  for (const double x: {double(cell.left()), double(cell.right())}) {
+    for (const double y: {double(cell.bottom()), double(cell.top())}) {
+      const double dx = x - area.x;
+      const double dy = y - area.y;
+      if (dx * dx + dy * dy >= area.radiusSqr) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+} // namespace tools
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <atomic>
+
+#include <Conveyor/IAbstractLogic.h>
+#include <Utils/Mutex.h>
+
+namespace world {
+class Cell;
+}
+
+namespace tools {
+
+// A request to find all physical objects, which centers are closer than
+// 'radius' to the center of some object. Requester keeps the query and
+// schedules it with 'requestAt()' call. When the time comes, the query is
+// answered by SpatialQueryEngine and it's results become available until the
+// next request.
+class SpatialQuery
+{
+  friend class SpatialQueryEngine;
+
+  enum State {
+    eIdle,
+    ePending,
+    eReady
+  };
+
+public:
+  struct CellHits {
+    const world::Cell* pCell;
+    uint32_t           nVersion;
+    bool               lCovered;
+    uint32_t           nBegin;
+    uint32_t           nEnd;
+  };
+    // Objects, found in the 'pCell', are stored in 'getResults()' in the
+    // [nBegin, nEnd) range. The 'nVersion' is a version of the cell at the
+    // moment it was read (see 'world::Cell::getVersion()'). If 'lCovered' is
+    // true, the cell is completely inside the radius, so all it's objects
+    // are in the results.
+
+  void requestAt(uint64_t nWhenUs, uint32_t nCenterObjectId, double radius);
+    // Request to find all objects around the object with the specified
+    // 'nCenterObjectId' at the specified 'nWhenUs' time (or a bit later).
+    // Position of the center object is taken when the query is answered.
+  void cancel() { m_eState = eIdle; }
+
+  bool isReady() const { return m_eState == eReady; }
+    // Return true if the last request has been answered
+  uint64_t answeredAt() const { return m_nAnsweredAtUs; }
+  bool isReady(uint64_t nowUs, uint64_t nMaxAgeUs) const {
+    return isReady() && nowUs - m_nAnsweredAtUs <= nMaxAgeUs;
+  }
+    // Return true if the last request has been answered not earlier than
+    // 'nMaxAgeUs' before 'nowUs'
+
+  std::vector<uint32_t> const& getResults() const { return m_results; }
+    // Return instance ids of found physical objects (including the center
+    // object itself)
+  std::vector<CellHits> const& getCells() const { return m_cells; }
+    // Return cells, where objects have been found
+
+private:
+  State    m_eState           = eIdle;
+  uint64_t m_nRequestedAtUs   = 0;
+  uint64_t m_nAnsweredAtUs    = 0;
+  uint32_t m_nCenterObjectId  = 0;
+  double   m_radius           = 0;
+
+  std::vector<uint32_t> m_results;
+  std::vector<CellHits> m_cells;
+};
+
+using SpatialQueryPtr     = std::shared_ptr<SpatialQuery>;
+using SpatialQueryWeakPtr = std::weak_ptr<SpatialQuery>;
+
+
+// Answers all spatial queries, that are due on the current tick, in one pass
+// over the global grid: queries are mapped to the cells, they cover, and then
+// cells are proceeded in the order they are stored in the grid. Every cell is
+// read once, no matter how many queries cover it. Threads take stripes of
+// consecutive cells, so the memory is accessed sequentially.
+//
+// Since scanners are proceeded after the engine (they read eFilters), a query,
+// that is due on some tick, is answered before requester is proceeded on
+// that tick.
+class SpatialQueryEngine : public conveyor::IAbstractLogic
+{
+  enum Stages {
+    eStageSearch  = 0,
+    eStagePublish = 1,
+    eTotalStages  = 2
+  };
+
+public:
+  static void setGlobal(SpatialQueryEngine* pEngine) { g_pGlobalEngine = pEngine; }
+  static SpatialQueryEngine* getGlobal() { return g_pGlobalEngine; }
+
+  void registerQuery(SpatialQueryPtr const& pQuery);
+    // Thread safe
+
+  // overrides from conveyor::IAbstractLogic
+  uint16_t getStagesCount() override { return eTotalStages; }
+  bool prephare(uint16_t nStageId, uint32_t nIntervalUs, uint64_t now) override;
+  void proceed(uint16_t nStageId, uint32_t nIntervalUs, uint64_t now) override;
+  size_t getCooldownTimeUs() const override { return 0; }
+  conveyor::DataAccess getDataAccess() const override {
+    return conveyor::DataAccess(conveyor::ePhysics | conveyor::eObjectsRegistry,
+                                conveyor::eFilters);
+  }
+
+private:
+  bool collectDueQueries(uint64_t now);
+  void searchInCells();
+  void publishResults(uint64_t now);
+
+private:
+  struct CellQuery {
+    const world::Cell* pCell;
+    uint32_t           nQueryId;
+    bool operator<(CellQuery const& other) const {
+      return pCell < other.pCell
+          || (pCell == other.pCell && nQueryId < other.nQueryId);
+    }
+  };
+
+  struct HitsRun {
+    uint32_t           nQueryId;
+    const world::Cell* pCell;
+    uint32_t           nVersion;
+    bool               lCovered;
+    uint32_t           nTotal;
+  };
+    // 'nTotal' objects, that have been found by the query in the cell (they
+    // are stored in 'm_hits' right after the objects of the previous run)
+
+  struct Area {
+    double x;
+    double y;
+    double radiusSqr;
+  };
+
+  static bool isCovered(const world::Cell& cell, const Area& area);
+
+  static SpatialQueryEngine* g_pGlobalEngine;
+
+  utils::Mutex                     m_queriesMutex;
+  std::vector<SpatialQueryWeakPtr> m_queries;
+
+  // Data of the current tick:
+  std::vector<SpatialQueryPtr> m_dueQueries;
+  std::vector<Area>            m_areas;
+    // Area of every due query (with the same index)
+  std::vector<CellQuery>       m_cellQueries;
+    // Sorted by cell, so all queries of the same cell are adjacent
+  std::vector<size_t>          m_stripes;
+    // Indexes in 'm_cellQueries', where stripes begin
+
+  std::atomic_size_t    m_nNextStripe;
+  utils::Mutex          m_hitsMutex;
+  std::vector<HitsRun>  m_runs;
+  std::vector<uint32_t> m_hits;
+};
+
+using SpatialQueryEnginePtr = std::shared_ptr<SpatialQueryEngine>;
+
+} // namespace tools
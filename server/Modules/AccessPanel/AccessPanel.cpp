@@ -63,6 +63,9 @@ void AccessPanel::handleMessage(uint32_t nSessionId, spex::Message const& messag
       sendLoginFailed(nSessionId, "Can't create UDP socket");
       return;
     }
+    if (m_lMessagesCoalescing) {
+      pPlayerSocket->enableCoalescing();
+    }
     pPlayer->attachToUdpSocket(pPlayerSocket);
   }
 
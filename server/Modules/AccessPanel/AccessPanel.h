@@ -31,6 +31,10 @@ public:
   void attachToPlayerStorage(world::PlayerStorageWeakPtr pPlayersStorage)
   { m_pPlayersStorage = pPlayersStorage; }
 
+  void enableMessagesCoalescing() { m_lMessagesCoalescing = true; }
+    // Messages, sent to player during a tick, will be coalesced into a few
+    // datagrams (see UdpSocket::enableCoalescing())
+
   // from BufferedTerminal->IBinaryTerminal interface:
   bool canOpenSession() const override { return true; }
   void openSession(uint32_t /*nSessionId*/) override {}
@@ -49,6 +53,11 @@ public:
     return 0;
 #endif
   }
+  conveyor::DataAccess getDataAccess() const override {
+    return conveyor::DataAccess(
+          conveyor::eInbox,
+          conveyor::ePlayers | conveyor::eObjectsRegistry | conveyor::eSessions);
+  }
 
 protected:
   // overrides from BufferedTerminal interface
@@ -66,6 +75,7 @@ private:
   network::UdpSocketPtr         m_pLoginSocket;
   network::UdpDispatcherPtr     m_pConnectionManager;
   world::PlayerStorageWeakPtr   m_pPlayersStorage;
+  bool                          m_lMessagesCoalescing = false;
 };
 
 } // namespace modules
@@ -3,6 +3,7 @@
 #include <random>
 #include <SystemManager.h>
 #include <Modules/Constants.h>
+#include <World/Player.h>
 
 namespace modules {
 
@@ -13,10 +14,14 @@ BaseModule::BaseModule(
   : m_sModuleType(std::move(sModuleType)),
   m_sModuleName(std::move(moduleName)),
   m_pOwner(std::move(pOwner)),
+  m_nOwnerId(0),
   m_eStatus(Status::eOnline),
   m_eState(State::eIdle)
 {
   m_activeSessons.reserve(constants::nSessionsPerModuleLimit);
+  if (world::PlayerPtr pPlayer = m_pOwner.lock()) {
+    m_nOwnerId = pPlayer->getPlayerId();
+  }
 }
 
 void BaseModule::installOn(modules::Ship* pShip)
@@ -69,6 +69,9 @@ public:
   void installOn(modules::Ship* pShip);
 
   world::PlayerWeakPtr getOwner() const { return m_pOwner; }
+  uint32_t getOwnerId() const { return m_nOwnerId; }
+    // Return id of the owner (see world::Player::getPlayerId()) or 0, if
+    // module has no owner
 
   // from IProtobufTerminal:
   // By default, there is no reason to reject new session opening and there is
@@ -112,6 +115,13 @@ protected:
     return network::BufferedPlayerTerminal::send(nSessionId, std::move(message));
   }
 
+  // Send the same message to several sessions. The message is serialized
+  // only once, no matter how many sessions are specified
+  inline size_t sendToClients(uint32_t const* pSessions, size_t nTotal,
+                              spex::Message const& message) const {
+    return network::BufferedPlayerTerminal::broadcast(pSessions, nTotal, message);
+  }
+
   void switchToIdleState() {
     if (m_eState != State::eIdle)
       m_eState = State::eDeactivating;
@@ -132,6 +142,7 @@ private:
   std::string           m_sModuleType;
   std::string           m_sModuleName;
   world::PlayerWeakPtr  m_pOwner;
+  uint32_t              m_nOwnerId;
   Status                m_eStatus;
   State                 m_eState;
   modules::Ship*        m_pPlatform = nullptr;
@@ -2,11 +2,15 @@
 
 #include <Modules/Ship/Ship.h>
 #include <Newton/PhysicalObject.h>
+#include <Newton/PhysicsStorage.h>
 #include <World/CelestialBodies/Asteroid.h>
 #include <World/Grid.h>
 #include <Utils/YamlReader.h>
+#include <Utils/Clock.h>
+#include <Modules/CommonModulesManager.h>
 
 #include <math.h>
+#include <algorithm>
 
 DECLARE_GLOBAL_CONTAINER_CPP(modules::CelestialScanner);
 
@@ -24,18 +28,27 @@ CelestialScanner::CelestialScanner(
 
 void CelestialScanner::proceed(uint32_t nIntervalUs)
 {
-  if (nIntervalUs < m_nScanningTimeLeftUs) {
-    m_nScanningTimeLeftUs -= nIntervalUs;
-    return;
+  if (!m_lReporting) {
+    if (nIntervalUs < m_nScanningTimeLeftUs) {
+      m_nScanningTimeLeftUs -= nIntervalUs;
+      return;
+    }
+    collectScanResults();
+    m_lReporting = true;
+  }
+  if (sendScanResults()) {
+    m_lReporting = false;
+    m_results.clear();
+    switchToIdleState();
   }
-  collectAndSendScanResults();
-  switchToIdleState();
 }
 
 void CelestialScanner::onSessionClosed(uint32_t nSessionId)
 {
   if (m_nTunnelId == nSessionId) {
-    m_nTunnelId = 0;
+    m_nTunnelId  = 0;
+    m_lReporting = false;
+    m_results.clear();
     switchToIdleState();
   }
   BaseModule::onSessionClosed(nSessionId);
@@ -90,59 +103,102 @@ void CelestialScanner::onScanRequest(
   uint32_t RTT_Us       = nScanningRadiusKm * 10 / 3;
   uint32_t resolution   = nScanningRadiusKm * 1000 / nMinimalRadius;
   m_nScanningTimeLeftUs = 100000 + 2 * RTT_Us + resolution * m_nProcessingTimeUs;
+
+  if (tools::SpatialQueryEngine* pEngine = tools::SpatialQueryEngine::getGlobal()) {
+    if (!m_pScanQuery) {
+      m_pScanQuery = std::make_shared<tools::SpatialQuery>();
+      pEngine->registerQuery(m_pScanQuery);
+    }
+    const newton::PhysicalObject* pPlatform = getPlatform();
+    m_pScanQuery->requestAt(
+          utils::GlobalClock::now() + m_nScanningTimeLeftUs,
+          pPlatform->getInstanceId(),
+          1000.0 * m_nScanningRadiusKm);
+  }
   switchToActiveState();
 }
 
-void CelestialScanner::collectAndSendScanResults()
+void CelestialScanner::collectScanResults()
 {
   geometry::Point const& selfPosition = getPlatform()->getPosition();
-  world::Grid* pGrid = world::Grid::getGlobal();
-  world::Grid::iterator itCell =
-      pGrid->range<double>(
-        selfPosition.x - m_nScanningRadiusKm * 1000,
-        selfPosition.y - m_nScanningRadiusKm * 1000,
-        2 * 1000 * m_nScanningRadiusKm,
-        2 * 1000 * m_nScanningRadiusKm);
 
   double maxRadiusSqr = 1000 * m_nScanningRadiusKm;
   maxRadiusSqr *= maxRadiusSqr;
 
-  std::vector<const world::Asteroid*> scannedAsteroids;
-  scannedAsteroids.reserve(32);
-  for (auto end = pGrid->end(); itCell != end; ++itCell) {
-    for (const uint32_t nObjectId: itCell->getObjects().data()) {
-      const newton::PhysicalObject* pObject =
-          utils::GlobalContainer<newton::PhysicalObject>::Instance(nObjectId);
-      if (pObject->is(world::ObjectType::eAsteroid)) {
-        const world::Asteroid* pAsteroid =
-            static_cast<const world::Asteroid*>(pObject);
-        if (pAsteroid->getRadius() < m_nMinimalRadius) {
-          continue;
+  m_results.clear();
+  m_nNextResult = 0;
+  // Asteroids are checked only; type of other objects is known without
+  // touching them (see 'Cell::getObjectType()' and 'PhysicsStorage::type')
+  auto checkAsteroid = [&](uint32_t nObjectId) {
+    const newton::PhysicalObject* pObject =
+        utils::GlobalContainer<newton::PhysicalObject>::Instance(nObjectId);
+    if (pObject && pObject->is(world::ObjectType::eAsteroid)) {
+      const world::Asteroid* pAsteroid =
+          static_cast<const world::Asteroid*>(pObject);
+      if (pAsteroid->getRadius() < m_nMinimalRadius) {
+        return;
+      }
+      const double distanceSqr =
+          selfPosition.distanceSqr(pAsteroid->getPosition());
+      if (distanceSqr < maxRadiusSqr)
+        m_results.push_back(ScannedItem{distanceSqr, nObjectId});
+    }
+  };
+
+  if (m_pScanQuery && m_pScanQuery->isReady(
+        utils::GlobalClock::now(),
+        static_cast<uint64_t>(Cooldown::eCelestialScanner))) {
+    // Objects around have been already collected by SpatialQueryEngine
+    newton::PhysicsStorage const& storage = newton::PhysicsStorage::instance();
+    for (const uint32_t nObjectId: m_pScanQuery->getResults()) {
+      if (nObjectId < storage.size()
+          && storage.getType(nObjectId) == world::ObjectType::eAsteroid) {
+        checkAsteroid(nObjectId);
+      }
+    }
+  } else {
+    world::Grid* pGrid = world::Grid::getGlobal();
+    world::Grid::iterator itCell =
+        pGrid->range<double>(
+          selfPosition.x - m_nScanningRadiusKm * 1000,
+          selfPosition.y - m_nScanningRadiusKm * 1000,
+          2 * 1000 * m_nScanningRadiusKm,
+          2 * 1000 * m_nScanningRadiusKm);
+    for (auto end = pGrid->end(); itCell != end; ++itCell) {
+      if (!itCell->countObjects(world::ObjectType::eAsteroid)) {
+        continue;
+      }
+      const utils::UnorderedVector<uint32_t>& objects = itCell->getObjects();
+      for (size_t i = 0; i < objects.size(); ++i) {
+        if (itCell->getObjectType(i) == world::ObjectType::eAsteroid) {
+          checkAsteroid(objects[i]);
         }
-        if (selfPosition.distanceSqr(pAsteroid->getPosition()) < maxRadiusSqr)
-          scannedAsteroids.push_back(pAsteroid);
       }
     }
   }
 
-  if (scannedAsteroids.empty()) {
-    spex::Message response;
-    spex::ICelestialScanner::ScanResults *pBody =
-        response.mutable_celestial_scanner()->mutable_scanning_report();
-    pBody->set_left(0);
-    sendToClient(m_nTunnelId, std::move(response));
-    return;
-  }
+  // Client gets the nearest asteroids first
+  std::sort(m_results.begin(), m_results.end());
+}
 
-  for (size_t i = 0; i < scannedAsteroids.size();)
-  {
+bool CelestialScanner::sendScanResults()
+{
+  size_t nBytesSent = 0;
+  do {
     spex::Message response;
     spex::ICelestialScanner::ScanResults *pBody =
         response.mutable_celestial_scanner()->mutable_scanning_report();
     auto pBatch = pBody->mutable_asteroids();
-    for (size_t j = 0; j < 10 && i < scannedAsteroids.size(); ++j, ++i)
-    {
-      const world::Asteroid* pAsteroid = scannedAsteroids[i];
+    while (pBatch->size() < 10 && m_nNextResult < m_results.size()) {
+      // Asteroid may have been destroyed since the results were collected
+      const newton::PhysicalObject* pObject =
+          utils::GlobalContainer<newton::PhysicalObject>::Instance(
+            m_results[m_nNextResult++].m_nObjectId);
+      if (!pObject || !pObject->is(world::ObjectType::eAsteroid)) {
+        continue;
+      }
+      const world::Asteroid* pAsteroid =
+          static_cast<const world::Asteroid*>(pObject);
 
       spex::ICelestialScanner::AsteroidInfo* pInfo = pBatch->Add();
       pInfo->set_id(pAsteroid->getAsteroidId());
@@ -152,9 +208,12 @@ void CelestialScanner::collectAndSendScanResults()
       pInfo->set_vy(pAsteroid->getVelocity().getY());
       pInfo->set_r(pAsteroid->getRadius());
     }
-    pBody->set_left(static_cast<uint32_t>(scannedAsteroids.size() - i));
+    pBody->set_left(static_cast<uint32_t>(m_results.size() - m_nNextResult));
+    nBytesSent += response.ByteSizeLong();
     sendToClient(m_nTunnelId, std::move(response));
-  }
+  } while (m_nNextResult < m_results.size()
+           && nBytesSent < nReportBytesPerTick);
+  return m_nNextResult == m_results.size();
 }
 
 } // namespace modules
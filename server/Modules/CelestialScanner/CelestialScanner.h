@@ -5,6 +5,7 @@
 #include <Utils/GlobalContainer.h>
 #include <Utils/YamlForwardDeclarations.h>
 #include <Protocol.pb.h>
+#include <ConveyorTools/SpatialQueryEngine.h>
 
 namespace world {
 class Asteroid;
@@ -17,6 +18,10 @@ class CelestialScanner :
     public utils::GlobalObject<CelestialScanner>
 {
 public:
+  static constexpr size_t nReportBytesPerTick = 16 * 1024;
+    // Results of a large scan are streamed to the client during several ticks,
+    // so the scan doesn't cause a burst of datagrams
+
   CelestialScanner(std::string&& sName, world::PlayerWeakPtr pOwner,
                    uint32_t m_nMaxScanningRadiusKm, uint32_t m_nProcessingTimeUs);
 
@@ -32,7 +37,11 @@ private:
   void onScanRequest(uint32_t nTunnelId, uint32_t nScanningRadiusKm,
                      uint32_t nMinimalRadius);
 
-  void collectAndSendScanResults();
+  void collectScanResults();
+    // Collect asteroids in the scanning radius to 'm_results' (nearest first)
+  bool sendScanResults();
+    // Send the next part of 'm_results', but not more than 'nReportBytesPerTick'
+    // bytes. Return true if all results have been sent.
 
 private:
   uint32_t m_nMaxScanningRadiusKm;
@@ -44,6 +53,23 @@ private:
   uint32_t m_nScanningRadiusKm = 0;
   uint32_t m_nMinimalRadius = 0;
   uint32_t m_nTunnelId      = 0;
+
+  tools::SpatialQueryPtr m_pScanQuery;
+    // Is used to collect objects around in advance (when the scanning is
+    // finished) by SpatialQueryEngine
+
+  struct ScannedItem {
+    double   m_distanceSqr;
+    uint32_t m_nObjectId;
+
+    bool operator<(ScannedItem const& other) const {
+      return m_distanceSqr < other.m_distanceSqr;
+    }
+  };
+  bool                     m_lReporting = false;
+    // Scanning is finished and results are being sent
+  std::vector<ScannedItem> m_results;
+  size_t                   m_nNextResult = 0;
 };
 
 } // namespace modules
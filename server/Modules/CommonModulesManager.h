@@ -100,6 +100,15 @@ public:
 
   size_t getCooldownTimeUs() const { return static_cast<size_t>(nCooldown); }
 
+  conveyor::DataAccess getDataAccess() const override {
+    // Every module handles it's own incoming messages and sends responses
+    // via opened sessions. Inheriter should extend it, if module reads or
+    // writes any other data
+    return conveyor::DataAccess(
+          conveyor::eObjectsRegistry | conveyor::eSessions | conveyor::eInbox,
+          conveyor::eNoData);
+  }
+
 protected:
   virtual bool prepareAdditionalStage([[maybe_unused]] uint16_t nStageId,
                                       [[maybe_unused]] uint32_t nIntervalUs,
@@ -64,6 +64,12 @@ public:
     return 0;
   }
 
+  conveyor::DataAccess getDataAccess() const override {
+    // Commutator opens and closes sessions to the modules
+    return conveyor::DataAccess(conveyor::eObjectsRegistry | conveyor::eInbox,
+                                conveyor::eSessions);
+  }
+
 private:
   void handleAllMessages()
   {
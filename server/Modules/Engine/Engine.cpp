@@ -18,7 +18,7 @@ void Engine::proceed(uint32_t nIntervalUs)
     m_nTimeLeftUs -= nIntervalUs;
     return;
   }
-  getPlatform()->getExternalForce_NoSync(m_nThrustVectorId).toZero();
+  getPlatform()->setExternalForce(m_nThrustVectorId, geometry::Vector());
   switchToIdleState();
   m_nTimeLeftUs = 0;
 }
@@ -28,8 +28,11 @@ bool Engine::loadState(YAML::Node const& source)
   if (!BaseModule::loadState(source))
     return false;
 
-  geometry::Vector& thrust = getPlatform()->getExternalForce_NoSync(m_nThrustVectorId);
-  return thrust.load(source);
+  geometry::Vector thrust;
+  if (!thrust.load(source))
+    return false;
+  getPlatform()->setExternalForce(m_nThrustVectorId, thrust);
+  return true;
 }
 
 void Engine::handleEngineMessage(uint32_t nSessionId, spex::IEngine const& message)
@@ -70,12 +73,10 @@ void Engine::getSpecification(uint32_t nSessionId) const
 
 void Engine::setThrust(const spex::IEngine::ChangeThrust &req)
 {
-  geometry::Vector& thrustVector =
-      getPlatform()->getExternalForce_NoSync(m_nThrustVectorId);
+  geometry::Vector thrustVector;
 
   uint32_t thrust = req.thrust();
   if (!thrust) {
-    thrustVector.toZero();
     m_nTimeLeftUs = 0;
     switchToIdleState();
   } else {
@@ -86,6 +87,7 @@ void Engine::setThrust(const spex::IEngine::ChangeThrust &req)
     m_nTimeLeftUs = req.duration_ms() * 1000;
     switchToActiveState();
   }
+  getPlatform()->setExternalForce(m_nThrustVectorId, thrustVector);
 }
 
 void Engine::getThrust(uint32_t nSessionId) const
@@ -94,7 +96,7 @@ void Engine::getThrust(uint32_t nSessionId) const
   spex::IEngine::CurrentThrust *pBody = response.mutable_engine()->mutable_thrust();
 
   geometry::Vector const& thrustVector =
-      getPlatform()->getExternalForce_NoSync(m_nThrustVectorId);
+      getPlatform()->getExternalForce(m_nThrustVectorId);
   pBody->set_x(thrustVector.getX());
   pBody->set_y(thrustVector.getY());
   pBody->set_thrust(uint32_t(thrustVector.getLength()));
@@ -5,23 +5,46 @@
 #include <Modules/ResourceContainer/ResourceContainerManager.h>
 #include <Modules/Commutator/CommutatorManager.h>
 
-#define DECLARE_DEFAULT_MODULE_MANAGER(ModuleCls) \
+#define DECLARE_DEFAULT_MODULE_MANAGER(ModuleCls, nReads, nWrites) \
   class ModuleCls##Manager\
   : public CommonModulesManager<ModuleCls, Cooldown::e##ModuleCls>\
-  {};
+  {\
+    using Base = CommonModulesManager<ModuleCls, Cooldown::e##ModuleCls>;\
+  public:\
+    conveyor::DataAccess getDataAccess() const override {\
+      conveyor::DataAccess access = Base::getDataAccess();\
+      access.m_nReads  |= (nReads);\
+      access.m_nWrites |= (nWrites);\
+      return access;\
+    }\
+  };
 
 namespace modules
 {
 
-DECLARE_DEFAULT_MODULE_MANAGER(AsteroidMiner)
-DECLARE_DEFAULT_MODULE_MANAGER(AsteroidScanner)
-DECLARE_DEFAULT_MODULE_MANAGER(BlueprintsStorage)
-DECLARE_DEFAULT_MODULE_MANAGER(CelestialScanner)
-DECLARE_DEFAULT_MODULE_MANAGER(Engine)
-DECLARE_DEFAULT_MODULE_MANAGER(PassiveScanner)
-DECLARE_DEFAULT_MODULE_MANAGER(Shipyard)
-DECLARE_DEFAULT_MODULE_MANAGER(Ship)
-DECLARE_DEFAULT_MODULE_MANAGER(SystemClock)
-DECLARE_DEFAULT_MODULE_MANAGER(Messanger)
+// Module managers, which data are read and written (in addition to the data,
+// that is used by any module, see CommonModulesManager::getDataAccess())
+DECLARE_DEFAULT_MODULE_MANAGER(AsteroidMiner,
+                               conveyor::eNoData, conveyor::ePhysics | conveyor::eResources)
+DECLARE_DEFAULT_MODULE_MANAGER(AsteroidScanner,
+                               conveyor::ePhysics | conveyor::eResources, conveyor::eNoData)
+DECLARE_DEFAULT_MODULE_MANAGER(BlueprintsStorage,
+                               conveyor::ePlayers, conveyor::eNoData)
+DECLARE_DEFAULT_MODULE_MANAGER(CelestialScanner,
+                               conveyor::ePhysics | conveyor::ePlayers | conveyor::eFilters,
+                               conveyor::eNoData)
+DECLARE_DEFAULT_MODULE_MANAGER(Engine,
+                               conveyor::eNoData, conveyor::ePhysics)
+DECLARE_DEFAULT_MODULE_MANAGER(PassiveScanner,
+                               conveyor::ePhysics | conveyor::ePlayers | conveyor::eFilters,
+                               conveyor::eNoData)
+DECLARE_DEFAULT_MODULE_MANAGER(Shipyard,
+                               conveyor::eAllData, conveyor::eAllData)
+DECLARE_DEFAULT_MODULE_MANAGER(Ship,
+                               conveyor::ePhysics, conveyor::eNoData)
+DECLARE_DEFAULT_MODULE_MANAGER(SystemClock,
+                               conveyor::eNoData, conveyor::eNoData)
+DECLARE_DEFAULT_MODULE_MANAGER(Messanger,
+                               conveyor::eNoData, conveyor::eNoData)
 
 } // namespace modules
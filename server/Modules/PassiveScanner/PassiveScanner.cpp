@@ -2,6 +2,7 @@
 
 #include <Utils/Clock.h>
 #include <Newton/PhysicalObject.h>
+#include <Newton/PhysicsStorage.h>
 #include <Modules/Ship/Ship.h>
 #include <World/CelestialBodies/Asteroid.h>
 #include <World/Grid.h>
@@ -9,6 +10,7 @@
 #include <Modules/CommonModulesManager.h>
 
 #include <math.h>
+#include <algorithm>
 #include <iostream>
 
 DECLARE_GLOBAL_CONTAINER_CPP(modules::PassiveScanner);
@@ -40,6 +42,21 @@ static void getTypeAndId(const newton::PhysicalObject* pObject,
   nId   = 0;
 }
 
+static bool isCoveredByRadius(const world::Cell&    cell,
+                              const geometry::Point& center,
+                              double                 radiusSqr)
+{
+  // Cell is covered if all it's corners are inside the radius
+  for (const double x: {double(cell.left()), double(cell.right())}) {
+    for (const double y: {double(cell.bottom()), double(cell.top())}) {
+      if (center.distanceSqr(geometry::Point(x, y)) >= radiusSqr) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 PassiveScanner::PassiveScanner(std::string&&        sName,
     world::PlayerWeakPtr pOwner,
     uint32_t             nMaxScanningRadiusKm,
@@ -57,7 +74,13 @@ void PassiveScanner::reset()
 {
   m_nLastGlobalUpdateUs = 0;
   m_detectedObjects.clear();
+  m_detectedIds.clear();
+  m_coveredCells.clear();
+  m_scanStats = GlobalScanStats();
   m_nMonitoringSessions.fill(0);
+  if (m_pGlobalScanQuery) {
+    m_pGlobalScanQuery->cancel();
+  }
   switchToIdleState();
 }
 
@@ -69,6 +92,7 @@ void PassiveScanner::proceed(uint32_t)
       nowUs - m_nLastGlobalUpdateUs > m_nEdgeUpdateTimeUs) {
     proceedGlobalScan();
     m_nLastGlobalUpdateUs = nowUs;
+    scheduleGlobalScan(nowUs + m_nEdgeUpdateTimeUs + 1);
   }
 
   if (m_detectedObjects.empty()) {
@@ -86,10 +110,13 @@ void PassiveScanner::proceed(uint32_t)
   size_t       totalObjectsToUpdate = 0;
   std::array<const newton::PhysicalObject*, updateLimit> objectsToUpdate;
 
-  while (m_detectedObjects.front().m_nWhenToUpdate <= nowUs
+  while (!m_detectedObjects.empty()
+         && m_detectedObjects.front().m_nWhenToUpdate <= nowUs
          && totalObjectsToUpdate < updateLimit) {
 
-    DetectedItem& item = m_detectedObjects.front();
+    std::pop_heap(m_detectedObjects.begin(), m_detectedObjects.end(),
+                  EarliestOnTop());
+    DetectedItem& item = m_detectedObjects.back();
     const newton::PhysicalObject* pObject =
         utils::GlobalContainer<newton::PhysicalObject>::Instance(
           item.m_nObjectId);
@@ -99,23 +126,19 @@ void PassiveScanner::proceed(uint32_t)
       item.m_nWhenToUpdate = updateTime;
 
       if (distance < m_nMaxScanningRadius) {
-        // Move element to keep vector sorted (one iteration of bubble sort)
-        for (size_t i = 1; i < m_detectedObjects.size(); ++i) {
-          if (m_detectedObjects[i - 1] < m_detectedObjects[i]) {
-            break;
-          } else {
-            std::swap(m_detectedObjects[i - 1], m_detectedObjects[i]);
-          }
-        }
-
+        // Return the item back to the heap with a new update time
+        std::push_heap(m_detectedObjects.begin(), m_detectedObjects.end(),
+                       EarliestOnTop());
         objectsToUpdate[totalObjectsToUpdate++] = pObject;
       } else {
         // Object is out of range
-        m_detectedObjects.erase(m_detectedObjects.begin());
+        forgetObject(pObject, item.m_nObjectId);
+        m_detectedObjects.pop_back();
       }
     } else {
-      // Remove item from array
-      m_detectedObjects.erase(m_detectedObjects.begin());
+      // Remove item from heap
+      forgetObject(nullptr, item.m_nObjectId);
+      m_detectedObjects.pop_back();
     }
   }
 
@@ -139,11 +162,14 @@ void PassiveScanner::proceed(uint32_t)
       pData->set_r(static_cast<float>(pObject->getRadius()));
     }
 
+    std::array<uint32_t, 8> sessions;
+    size_t                  nTotalSessions = 0;
     for (const uint32_t nSession: m_nMonitoringSessions) {
       if (nSession) {
-        sendToClient(nSession, std::move(message));
+        sessions[nTotalSessions++] = nSession;
       }
     }
+    sendToClients(sessions.data(), nTotalSessions, message);
   }
 }
 
@@ -223,72 +249,127 @@ void PassiveScanner::proceedGlobalScan()
   const world::Grid*     pGrid       = world::Grid::getGlobal();
   const geometry::Point& position    = pPlatform->getPosition();
   const uint64_t         nowUs       = utils::GlobalClock::now();
+  const uint32_t         nOwnerId    = getOwnerId();
 
-  // Should sort 'm_detectedObjects' by objectsId in order to use binary
-  // search
-  auto compareById = [](const DetectedItem& left, const DetectedItem& right) {
-    return left.m_nObjectId < right.m_nObjectId;
-  };
-  std::sort(m_detectedObjects.begin(), m_detectedObjects.end(), compareById);
-
-  std::vector<DetectedItem> oldData = std::move(m_detectedObjects);
-  std::vector<DetectedItem> newData;
-  newData.reserve(oldData.capacity());
-
-  world::Grid::iterator itCell = pGrid->range(
-        position.x - m_nMaxScanningRadius,
-        position.y - m_nMaxScanningRadius,
-        scanningAreaSize,
-        scanningAreaSize);
-
-  for (world::Grid::iterator end = pGrid->end(); itCell != end; ++itCell) {
-    for (uint32_t nObjectId: itCell->getObjects().data()) {
-      const newton::PhysicalObject* pObject =
-          utils::GlobalContainer<newton::PhysicalObject>::Instance(nObjectId);
-
-      if (pObject) {
-        if (pObject->is(world::ObjectType::eShip) &&
-            static_cast<const modules::Ship*>(pObject)->getOwner().lock()
-            == getOwner().lock()) {
-          // Ignore ships, that belong to the same player
-          continue;
-        }
-
-        if (position.distanceSqr(pObject->getPosition()) < scanningRadiusSqr) {
-          const auto distanceAndTime = getDistanceAndUpdateTime(*pObject, nowUs);
-          newData.push_back(DetectedItem{distanceAndTime.second, nObjectId});
-        }
+  const newton::PhysicsStorage& storage = newton::PhysicsStorage::instance();
+  auto checkObject = [&](uint32_t nObjectId) {
+    if (m_detectedIds.count(nObjectId)) {
+      // Will be updated in time by 'proceed()'
+      return;
+    }
+    if (nObjectId < storage.size() && storage.isOwnedBy(nObjectId, nOwnerId)) {
+      // Ignore ships, that belong to the same player
+      return;
+    }
+    const newton::PhysicalObject* pObject =
+        utils::GlobalContainer<newton::PhysicalObject>::Instance(nObjectId);
+
+    if (pObject) {
+      if (position.distanceSqr(pObject->getPosition()) < scanningRadiusSqr) {
+        const auto distanceAndTime = getDistanceAndUpdateTime(*pObject, nowUs);
+        m_detectedObjects.push_back(
+              DetectedItem{distanceAndTime.second, nObjectId});
+        std::push_heap(m_detectedObjects.begin(), m_detectedObjects.end(),
+                       EarliestOnTop());
+        m_detectedIds.insert(nObjectId);
       }
     }
-  }
-  std::sort(newData.begin(), newData.end(), compareById);
-
-  // Now 'm_detectedObjects' has a new set of objects and 'oldData' has a
-  // previous one. Both are sorted by Id. We should copy update time from
-  // 'oldData' items to corresponding 'newData' items.
-  // Since both are sorted, we may use kind of 'merge sorting' approach
-  size_t       i    = 0;  // iterate through oldData
-  const size_t iEnd = oldData.size();
-  size_t       j    = 0;  // iterate through newData
-  const size_t jEnd = newData.size();
-
-  while(i < iEnd && j < jEnd) {
-    const DetectedItem& oldItem = oldData[i];
-    DetectedItem&       newItem = newData[j];
-    if (oldItem.m_nObjectId == newItem.m_nObjectId) {
-      newItem.m_nWhenToUpdate = oldItem.m_nWhenToUpdate;
-      ++i;
-      ++j;
-    } else if (oldItem.m_nObjectId < newItem.m_nObjectId) {
-      ++i;
-    } else {
-      ++j;
+  };
+
+  m_nextCoveredCells.clear();
+  ++m_scanStats.nTotalScans;
+  auto checkCell = [&](const world::Cell& cell,
+                       uint32_t           nVersion,
+                       bool               lCovered,
+                       const uint32_t*    pBegin,
+                       const uint32_t*    pEnd) {
+    if (lCovered) {
+      m_nextCoveredCells.push_back(CellSnapshot{&cell, nVersion});
+    }
+    if (!isCellChanged(cell, nVersion, lCovered)) {
+      ++m_scanStats.nCellsSkipped;
+      return;
+    }
+    ++m_scanStats.nCellsChecked;
+    for (const uint32_t* pObjectId = pBegin; pObjectId != pEnd; ++pObjectId) {
+      checkObject(*pObjectId);
+    }
+  };
+
+  // Results of the query may be used only if they have been collected
+  // recently (scanner may be proceeded a bit later, than the query is answered)
+  if (m_pGlobalScanQuery && m_pGlobalScanQuery->isReady(
+        nowUs, static_cast<uint64_t>(Cooldown::ePassiveScanner))) {
+    // Objects around have been already collected by SpatialQueryEngine, cell
+    // by cell, with the versions cells had at that moment
+    const uint32_t* pResults = m_pGlobalScanQuery->getResults().data();
+    for (const auto& cellHits: m_pGlobalScanQuery->getCells()) {
+      checkCell(*cellHits.pCell, cellHits.nVersion, cellHits.lCovered,
+                pResults + cellHits.nBegin, pResults + cellHits.nEnd);
+    }
+  } else {
+    world::Grid::iterator itCell = pGrid->range(
+          position.x - m_nMaxScanningRadius,
+          position.y - m_nMaxScanningRadius,
+          scanningAreaSize,
+          scanningAreaSize);
+    for (world::Grid::iterator end = pGrid->end(); itCell != end; ++itCell) {
+      const std::vector<uint32_t>& objects = itCell->getObjects().data();
+      checkCell(*itCell, itCell->getVersion(),
+                isCoveredByRadius(*itCell, position, scanningRadiusSqr),
+                objects.data(), objects.data() + objects.size());
     }
   }
+  std::sort(m_nextCoveredCells.begin(), m_nextCoveredCells.end());
+  std::swap(m_coveredCells, m_nextCoveredCells);
+}
+
+bool PassiveScanner::isCellChanged(
+    const world::Cell& cell, uint32_t nVersion, bool lCovered) const
+{
+  if (!lCovered) {
+    return true;
+  }
+  auto I = std::lower_bound(m_coveredCells.begin(), m_coveredCells.end(),
+                            CellSnapshot{&cell, 0});
+  return I == m_coveredCells.end() || I->m_pCell != &cell
+      || I->m_nVersion != nVersion;
+}
 
-  // 'm_detectedObjects' should be sorted by update time
-  std::sort(newData.begin(), newData.end());
-  m_detectedObjects = std::move(newData);
+void PassiveScanner::forgetObject(
+    const newton::PhysicalObject* pObject, uint32_t nObjectId)
+{
+  m_detectedIds.erase(nObjectId);
+  if (!pObject) {
+    return;
+  }
+  // Object has left the scanning radius, but it's cell may still be covered,
+  // so the cell should be checked by the next global scan (the object may
+  // return)
+  const world::Grid* pGrid = world::Grid::getGlobal();
+  const geometry::Point& position = pObject->getPosition();
+  const world::Cell* pCell = pGrid ? pGrid->getCell(position.x, position.y)
+                                   : nullptr;
+  auto I = std::lower_bound(m_coveredCells.begin(), m_coveredCells.end(),
+                            CellSnapshot{pCell, 0});
+  if (I != m_coveredCells.end() && I->m_pCell == pCell) {
+    m_coveredCells.erase(I);
+  }
+}
+
+void PassiveScanner::scheduleGlobalScan(uint64_t nWhenUs)
+{
+  tools::SpatialQueryEngine* pEngine = tools::SpatialQueryEngine::getGlobal();
+  if (!pEngine) {
+    return;
+  }
+  if (!m_pGlobalScanQuery) {
+    m_pGlobalScanQuery = std::make_shared<tools::SpatialQuery>();
+    pEngine->registerQuery(m_pGlobalScanQuery);
+  }
+  const newton::PhysicalObject* pPlatform = getPlatform();
+  m_pGlobalScanQuery->requestAt(
+        nWhenUs, pPlatform->getInstanceId(), m_nMaxScanningRadius);
 }
 
 std::pair<double, uint64_t> PassiveScanner::getDistanceAndUpdateTime(
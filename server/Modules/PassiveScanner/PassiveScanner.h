@@ -2,16 +2,23 @@
 
 #include <memory>
 #include <array>
+#include <functional>
+#include <unordered_set>
 #include <Modules/BaseModule.h>
 #include <Utils/GlobalContainer.h>
 #include <Utils/YamlForwardDeclarations.h>
 #include <Protocol.pb.h>
 #include <Geometry/Point.h>
+#include <ConveyorTools/SpatialQueryEngine.h>
 
 namespace newton {
 class PhysicalObject;
 }
 
+namespace world {
+class Cell;
+}
+
 namespace modules {
 
 class PassiveScanner :
@@ -30,6 +37,16 @@ public:
 
   void onSessionClosed(uint32_t nSessionId) override;
 
+  struct GlobalScanStats {
+    uint32_t nTotalScans   = 0;
+    uint32_t nCellsChecked = 0;
+    uint32_t nCellsSkipped = 0;
+      // Cells, that haven't been changed since the previous global scan
+  };
+
+  GlobalScanStats const& getGlobalScanStats() const { return m_scanStats; }
+    // Return statistics of all global scans since the last 'reset()' call
+
 private:
   void handlePassiveScannerMessage(
       uint32_t nSessionId, spex::IPassiveScanner const& message) override;
@@ -40,6 +57,19 @@ private:
   void sendMonitorAck(uint32_t nSessionId, bool status);
 
   void proceedGlobalScan();
+    // Look for objects, that have got into the scanning radius since the
+    // previous global scan. Objects, that are already detected, are not
+    // checked here: they are checked by 'proceed()' when their update time
+    // comes (and are forgotten, if they have left the scanning radius).
+  bool isCellChanged(
+      const world::Cell& cell, uint32_t nVersion, bool lCovered) const;
+    // Return false if the specified 'cell' has been covered by the scanning
+    // radius since the previous global scan and it still has the same
+    // 'nVersion' (so all objects of the cell are already detected)
+  void forgetObject(const newton::PhysicalObject* pObject, uint32_t nObjectId);
+  void scheduleGlobalScan(uint64_t nWhenUs);
+    // Ask the global SpatialQueryEngine to collect objects around the
+    // platform before the next global scan (if engine is available)
 
   std::pair<double, uint64_t> getDistanceAndUpdateTime(
       const newton::PhysicalObject& other, uint64_t now) const;
@@ -50,16 +80,36 @@ private:
 
   uint64_t                m_nLastGlobalUpdateUs;
   std::array<uint32_t, 8> m_nMonitoringSessions;
+  tools::SpatialQueryPtr  m_pGlobalScanQuery;
 
   struct DetectedItem {
     uint64_t m_nWhenToUpdate;
     uint32_t m_nObjectId;
 
-    bool operator<(const DetectedItem& other) const {
-      return m_nWhenToUpdate < other.m_nWhenToUpdate;
+    bool operator>(const DetectedItem& other) const {
+      return m_nWhenToUpdate > other.m_nWhenToUpdate;
+    }
+  };
+  using EarliestOnTop = std::greater<DetectedItem>;
+
+  std::vector<DetectedItem>    m_detectedObjects;
+    // A heap, where the object, that should be updated first, is on top
+  std::unordered_set<uint32_t> m_detectedIds;
+    // Ids of all objects in 'm_detectedObjects'
+
+  struct CellSnapshot {
+    const world::Cell* m_pCell;
+    uint32_t           m_nVersion;
+
+    bool operator<(const CellSnapshot& other) const {
+      return m_pCell < other.m_pCell;
     }
   };
-  std::vector<DetectedItem> m_detectedObjects;
+  std::vector<CellSnapshot> m_coveredCells;
+    // Cells, that were completely covered by the scanning radius during the
+    // previous global scan (sorted by address)
+  std::vector<CellSnapshot> m_nextCoveredCells;
+  GlobalScanStats           m_scanStats;
 };
 
 } // namespace modules
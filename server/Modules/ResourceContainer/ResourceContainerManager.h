@@ -11,6 +11,12 @@ class ResourceContainerManager
 public:
   uint16_t getStagesCount() { return Base::getStagesCount() + 1; }
 
+  conveyor::DataAccess getDataAccess() const override {
+    conveyor::DataAccess access = Base::getDataAccess();
+    access.m_nWrites |= conveyor::ePhysics | conveyor::eResources;
+    return access;
+  }
+
 protected:
   virtual bool prepareAdditionalStage(uint16_t nStageId,
                                       uint32_t nIntervalUs,
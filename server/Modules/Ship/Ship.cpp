@@ -6,6 +6,7 @@
 #include <Utils/YamlReader.h>
 #include <Utils/Clock.h>
 #include <World/Player.h>
+#include <Newton/PhysicsStorage.h>
 
 DECLARE_GLOBAL_CONTAINER_CPP(modules::Ship);
 
@@ -24,6 +25,10 @@ Ship::Ship(
     newton::PhysicalObject(weight, radius)
 {
   GlobalObject<Ship>::registerSelf(this);
+  newton::PhysicsStorage& storage = newton::PhysicsStorage::instance();
+  storage.ownerId[newton::PhysicalObject::getInstanceId()] = getOwnerId();
+  storage.setType(newton::PhysicalObject::getInstanceId(),
+                  world::ObjectType::eShip);
   m_pCommutator = std::make_shared<modules::Commutator>(
     getOwner().lock()->getSessionMux()
   );
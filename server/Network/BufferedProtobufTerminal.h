@@ -1,8 +1,11 @@
 #pragma once
 
 #include "Interfaces.h"
+#include <algorithm>
 #include <functional>
+#include <unordered_map>
 #include <vector>
+#include <google/protobuf/arena.h>
 
 #include <Utils/Clock.h>
 
@@ -31,6 +34,19 @@ public:
 
   void handleBufferedMessages();
 
+  struct DelayedQueueStats {
+    size_t   nQueued                = 0;
+    uint64_t nDroppedByTotalLimit   = 0;
+    uint64_t nDroppedBySessionLimit = 0;
+  };
+  DelayedQueueStats const& getDelayedQueueStats() const { return m_delayedStats; }
+
+  static constexpr size_t nDelayedQueueLimit      = 4096;
+  static constexpr size_t nDelayedPerSessionLimit = 256;
+    // Messages with a future timestamp, that exceed any of these limits, are
+    // dropped (and counted in DelayedQueueStats). The per-session limit
+    // doesn't let one client to take the whole queue.
+
 protected:
   virtual void handleMessage(uint32_t nSessionId, FrameType const& message) = 0;
   bool channelIsValid() const { return m_pChannel && m_pChannel->isValid(); }
@@ -39,6 +55,11 @@ protected:
     return m_pChannel && m_pChannel->send(nSessionId, std::move(message));
   }
 
+  size_t broadcast(uint32_t const* pSessions, size_t nTotal,
+                   FrameType const& message) const {
+    return m_pChannel ? m_pChannel->broadcast(pSessions, nTotal, message) : 0;
+  }
+
   void closeSession(uint32_t nSessionId) {
     if (m_pChannel) {
       m_pChannel->closeSession(nSessionId);
@@ -50,20 +71,46 @@ protected:
 private:
   struct BufferedMessage
   {
-    BufferedMessage(uint32_t nSessionId, FrameType const& message)
-      : m_nSessionId(nSessionId), m_body(message)
+    uint32_t   m_nSessionId = 0;
+    FrameType* m_pBody      = nullptr;
+      // Is allocated in 'm_arena'
+  };
+
+  struct DelayedMessage
+  {
+    DelayedMessage(uint32_t nSessionId, uint64_t nSeqNo, FrameType const& message)
+      : m_nSessionId(nSessionId), m_nSeqNo(nSeqNo), m_body(message)
     {}
     uint32_t  m_nSessionId = 0;
+    uint64_t  m_nSeqNo     = 0;
+      // Messages with the same timestamp are handled in order they came
     FrameType m_body;
   };
 
-  void drawnDelayedMessage();
+  static bool isLater(DelayedMessage const& left, DelayedMessage const& right)
+  {
+    return left.m_body.timestamp() > right.m_body.timestamp()
+        || (left.m_body.timestamp() == right.m_body.timestamp()
+            && left.m_nSeqNo > right.m_nSeqNo);
+  }
+
+  void delayMessage(uint32_t nSessionId, FrameType const& message);
+  void handleDelayedMessages(uint64_t now);
 
 private:
   ChannelPtr                   m_pChannel;
+  google::protobuf::Arena      m_arena;
+    // Is reset once all buffered messages are handled, so copying of
+    // received messages requires no heap allocations (except new arena's
+    // blocks)
   std::vector<BufferedMessage> m_messages;
-  // Messages, that are waiting for exact time to be handled
-  std::vector<BufferedMessage> m_delayedMessages;
+  // Messages, that are waiting for exact time to be handled. They may live
+  // longer than the arena, so they are copied out of it. It's a heap, where
+  // the earliest message is on top.
+  std::vector<DelayedMessage>  m_delayedMessages;
+  std::unordered_map<uint32_t, size_t> m_nDelayedPerSession;
+  uint64_t                     m_nNextSeqNo = 0;
+  DelayedQueueStats            m_delayedStats;
 };
 
 
@@ -75,56 +122,67 @@ template<typename FrameType>
 void BufferedProtobufTerminal<FrameType>::onMessageReceived(
     uint32_t nSessionId, FrameType const& message)
 {
-  m_messages.emplace_back(nSessionId, message);
+  FrameType* pBody = google::protobuf::Arena::CreateMessage<FrameType>(&m_arena);
+  pBody->CopyFrom(message);
+  m_messages.push_back(BufferedMessage{nSessionId, pBody});
 }
 
 template<typename FrameType>
 void BufferedProtobufTerminal<FrameType>::handleBufferedMessages()
 {
-  const uint16_t delayedQueueLimit = 1024;
-  const uint64_t now               = utils::GlobalClock::now();
+  const uint64_t now = utils::GlobalClock::now();
 
   for(BufferedMessage& message : m_messages) {
-    if (now < message.m_body.timestamp()) {
-      if (m_delayedMessages.size() == delayedQueueLimit) {
-        // Drop the message :(
-        return;
-      }
-      m_delayedMessages.emplace_back(std::move(message));
-      drawnDelayedMessage();
+    FrameType const& body = *message.m_pBody;
+    if (now < body.timestamp()) {
+      delayMessage(message.m_nSessionId, body);
     } else {
       // Handle immediatelly
-      handleMessage(message.m_nSessionId, message.m_body);
+      handleMessage(message.m_nSessionId, body);
     }
   }
   m_messages.clear();
+  m_arena.Reset();
 
-  while(!m_delayedMessages.empty()) {
-    BufferedMessage& message = m_delayedMessages.back();
-    const uint64_t ts = message.m_body.timestamp();
-    if (ts <= now) {
-      handleMessage(message.m_nSessionId, message.m_body);
-      m_delayedMessages.pop_back();
-    } else {
-      break;
-    }
+  handleDelayedMessages(now);
+}
+
+template<typename FrameType>
+void BufferedProtobufTerminal<FrameType>::delayMessage(
+    uint32_t nSessionId, FrameType const& message)
+{
+  if (m_delayedMessages.size() >= nDelayedQueueLimit) {
+    ++m_delayedStats.nDroppedByTotalLimit;
+    return;
+  }
+  size_t& nDelayed = m_nDelayedPerSession[nSessionId];
+  if (nDelayed >= nDelayedPerSessionLimit) {
+    ++m_delayedStats.nDroppedBySessionLimit;
+    return;
   }
+  ++nDelayed;
+
+  m_delayedMessages.emplace_back(nSessionId, m_nNextSeqNo++, message);
+  std::push_heap(m_delayedMessages.begin(), m_delayedMessages.end(), isLater);
+  m_delayedStats.nQueued = m_delayedMessages.size();
 }
 
 template<typename FrameType>
-void BufferedProtobufTerminal<FrameType>::drawnDelayedMessage()
+void BufferedProtobufTerminal<FrameType>::handleDelayedMessages(uint64_t now)
 {
-  // Here we assume, that all elements in m_delayedMessages are already
-  // sorted (by descending timestamp), except the last one, which should
-  // be placed to a proper position.
-  const uint64_t ts = m_delayedMessages.back().m_body.timestamp();
-  for (size_t i = m_delayedMessages.size() - 1; i > 0; --i) {
-    if (m_delayedMessages[i-1].m_body.timestamp() < ts) {
-      std::swap(m_delayedMessages[i-1], m_delayedMessages[i]);
-    } else {
-      return;
+  while(!m_delayedMessages.empty()
+        && m_delayedMessages.front().m_body.timestamp() <= now) {
+    std::pop_heap(m_delayedMessages.begin(), m_delayedMessages.end(), isLater);
+    DelayedMessage& message = m_delayedMessages.back();
+
+    auto I = m_nDelayedPerSession.find(message.m_nSessionId);
+    if (I != m_nDelayedPerSession.end() && --I->second == 0) {
+      m_nDelayedPerSession.erase(I);
     }
+    handleMessage(message.m_nSessionId, message.m_body);
+    m_delayedMessages.pop_back();
   }
+  m_delayedStats.nQueued = m_delayedMessages.size();
 }
 
 } // namespace network
@@ -2,6 +2,7 @@
 
 #include <stdint.h>
 #include <memory>
+#include <type_traits>
 
 #include <Protocol.pb.h>
 #include <Privileged.pb.h>
@@ -33,6 +34,13 @@ public:
   virtual bool send(uint32_t nSessionId, FrameType&& frame) = 0;
   virtual void closeSession(uint32_t nSessionId) = 0;
 
+  // Send the same 'frame' to every of 'nTotal' sessions, specified by
+  // 'pSessions'. Return a number of sessions, to which the frame has been sent.
+  // By default the frame is just copied and sent to every session; channels
+  // may override it to do the common work (e.g. serialization) only once.
+  virtual size_t broadcast(uint32_t const* pSessions, size_t nTotal,
+                           FrameType const& frame);
+
   virtual bool isValid() const = 0;
 
   virtual void attachToTerminal(ITerminalPtr<FrameType> pTerminal) = 0;
@@ -82,6 +90,25 @@ struct BinaryMessage
 };
 
 
+template<typename FrameType>
+size_t IChannel<FrameType>::broadcast(
+    uint32_t const* pSessions, size_t nTotal, FrameType const& frame)
+{
+  size_t nSent = 0;
+  for (size_t i = 0; i < nTotal; ++i) {
+    if constexpr (std::is_copy_constructible_v<FrameType>) {
+      FrameType copy(frame);
+      nSent += send(pSessions[i], std::move(copy)) ? 1 : 0;
+    } else {
+      // BinaryMessage doesn't own the body, so only a view is copied
+      FrameType view(frame.m_pBody, frame.m_nLength);
+      nSent += send(pSessions[i], std::move(view)) ? 1 : 0;
+    }
+  }
+  return nSent;
+}
+
+
 using IBinaryChannel             = IChannel<BinaryMessage>;
 using IBinaryChannelPtr          = IChannelPtr<BinaryMessage>;
 using IBinaryChannelWeakPtr      = IChannelWeakPtr<BinaryMessage>;
@@ -1,10 +1,15 @@
 #pragma once
 
+#include <array>
 #include <memory>
+#include <google/protobuf/arena.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
 
 #include <Utils/MessageUtil.h>
 #include <Network/Interfaces.h>
 #include <Network/BufferedTerminal.h>
+#include <Network/UdpSocket.h>
 
 // This is useful for integration tests debugging
 // #define PRINT_MESSAGES
@@ -21,6 +26,8 @@ class ProtobufChannel : public IBinaryTerminal, public IChannel<FrameType>
   using Terminal = ITerminal<FrameType>;
   using TerminalPtr = std::shared_ptr<Terminal>;
 public:
+  ProtobufChannel() : m_arena(m_arenaBlock.data(), m_arenaBlock.size()) {}
+
   // from IBinaryTerminal interface:
   void attachToChannel(IBinaryChannelPtr pChannel) override;
   void detachFromChannel() override;
@@ -29,6 +36,13 @@ public:
   void onMessageReceived(uint32_t nSessionId, BinaryMessage const& message) override;
   void onSessionClosed(uint32_t nSessionId) override;
 
+  bool enableBatching();
+    // Send every message as a batch of one message (in the 'batch' field of
+    // the 'FrameType'). Concatenated batches are parsed as a single batch, so
+    // the channel may be attached to a coalescing socket (see
+    // UdpSocket::enableCoalescing()). Return false if 'FrameType' has no
+    // 'batch' field.
+
   // Overrides of IChannel<FrameType> interface
   bool send(uint32_t nSessionId, FrameType&& message) override;
   void attachToTerminal(TerminalPtr pTerminal) override;
@@ -36,9 +50,32 @@ public:
   void closeSession(uint32_t nSessionId) override;
   bool isValid() const override;
 
+  bool sendSerialized(uint32_t nSessionId, std::string const& body,
+                      FrameType const& header);
+    // Send the 'body', that has been serialized once for several sessions,
+    // with a session specific 'header' appended to it. Since concatenated
+    // messages are merged when parsed, fields of the 'header' override the
+    // same fields of the 'body'.
+
+private:
+  size_t writeBatchHeader(uint8_t* pHeader, size_t nMessageLength) const;
+    // Write a header of the batch, that contains a message of
+    // 'nMessageLength' bytes. Return length of the header.
+
 private:
   TerminalPtr       m_pTerminal;
   IBinaryChannelPtr m_pChannel;
+  UdpSocketPtr      m_pUdpSocket;
+    // The same channel as 'm_pChannel', if it is a UDP socket. Messages are
+    // serialized right into it's buffers.
+  uint32_t          m_nBatchTag = 0;
+    // Tag of the 'batch' field, if batching is enabled
+
+  // Incoming messages are parsed into the arena, which is reset after every
+  // message. While a message fits into the initial block, parsing doesn't
+  // allocate any memory on the heap. Arena requires the block to be aligned.
+  alignas(8) std::array<char, 4096> m_arenaBlock;
+  google::protobuf::Arena           m_arena;
 };
 
 using PlayerChannel = ProtobufChannel<spex::Message>;
@@ -48,16 +85,43 @@ using PrivilegedChannel = ProtobufChannel<admin::Message>;
 using PrivilegedChannelPtr = std::shared_ptr<PrivilegedChannel>;
 
 
+template<typename FrameType>
+bool ProtobufChannel<FrameType>::enableBatching()
+{
+  using WireFormatLite = google::protobuf::internal::WireFormatLite;
+  google::protobuf::FieldDescriptor const* pBatchField =
+      FrameType::descriptor()->FindFieldByName("batch");
+  if (!pBatchField) {
+    return false;
+  }
+  m_nBatchTag = WireFormatLite::MakeTag(
+        pBatchField->number(), WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+  return true;
+}
+
+template<typename FrameType>
+size_t ProtobufChannel<FrameType>::writeBatchHeader(
+    uint8_t* pHeader, size_t nMessageLength) const
+{
+  using CodedOutputStream = google::protobuf::io::CodedOutputStream;
+  uint8_t* pEnd = CodedOutputStream::WriteTagToArray(m_nBatchTag, pHeader);
+  pEnd = CodedOutputStream::WriteVarint32ToArray(
+        static_cast<uint32_t>(nMessageLength), pEnd);
+  return static_cast<size_t>(pEnd - pHeader);
+}
+
 template<typename FrameType>
 void ProtobufChannel<FrameType>::attachToChannel(IBinaryChannelPtr pChannel)
 {
-  m_pChannel = pChannel;
+  m_pChannel   = pChannel;
+  m_pUdpSocket = std::dynamic_pointer_cast<UdpSocket>(pChannel);
 }
 
 template<typename FrameType>
 void ProtobufChannel<FrameType>::detachFromChannel()
 {
   m_pChannel.reset();
+  m_pUdpSocket.reset();
 }
 
 template<typename FrameType>
@@ -80,18 +144,20 @@ template<typename FrameType>
 void ProtobufChannel<FrameType>::onMessageReceived(
     uint32_t nSessionId, BinaryMessage const& message)
 {
-  FrameType pdu;
-  if (pdu.ParseFromArray(message.m_pBody, static_cast<int>(message.m_nLength))) {
+  FrameType* pPdu = google::protobuf::Arena::CreateMessage<FrameType>(&m_arena);
+  if (pPdu->ParseFromArray(message.m_pBody, static_cast<int>(message.m_nLength))) {
 
 #ifdef PRINT_MESSAGES
-    if (utils::isPlayerMessage(pdu) && !utils::isHeartbeat(pdu)) {
-      std::cerr << "Received in #" << nSessionId << ":\n" << pdu.DebugString()
+    if (utils::isPlayerMessage(*pPdu) && !utils::isHeartbeat(*pPdu)) {
+      std::cerr << "Received in #" << nSessionId << ":\n" << pPdu->DebugString()
       << std::endl;
     }
 #endif
 
-    m_pTerminal->onMessageReceived(nSessionId, std::move(pdu));
+    m_pTerminal->onMessageReceived(nSessionId, *pPdu);
   }
+  // Terminal should have copied the message, if it needs it later
+  m_arena.Reset();
 }
 
 template<typename FrameType>
@@ -104,9 +170,6 @@ void ProtobufChannel<FrameType>::onSessionClosed(uint32_t nSessionId)
 template<typename FrameType>
 bool ProtobufChannel<FrameType>::send(uint32_t nSessionId, FrameType&& message)
 {
-  std::string buffer;
-  message.SerializeToString(&buffer);
-
 #ifdef PRINT_MESSAGES
   if (utils::isPlayerMessage(message) && !utils::isHeartbeat(message)) {
     std::cerr << "Sending in #" << nSessionId << ":\n"
@@ -114,10 +177,62 @@ bool ProtobufChannel<FrameType>::send(uint32_t nSessionId, FrameType&& message)
   }
 #endif
 
+  // Both tag and length of the batch are 32-bit varints (up to 5 bytes each)
+  uint8_t      header[10];
+  const size_t nMessageLength = message.ByteSizeLong();
+  const size_t nHeaderLength  =
+      m_nBatchTag ? writeBatchHeader(header, nMessageLength) : 0;
+
+  if (m_pUdpSocket) {
+    // Size of the message has been cached by 'ByteSizeLong()' call, so it is
+    // serialized without any checks (and without locking the socket)
+    return m_pUdpSocket->sendInPlace(
+          nSessionId, nHeaderLength + nMessageLength,
+          [&message, &header, nHeaderLength](uint8_t* pBuffer) {
+      memcpy(pBuffer, header, nHeaderLength);
+      message.SerializeWithCachedSizesToArray(pBuffer + nHeaderLength);
+    });
+  }
+
+  std::string buffer(nHeaderLength + nMessageLength, '\0');
+  uint8_t* pBuffer = reinterpret_cast<uint8_t*>(&buffer[0]);
+  memcpy(pBuffer, header, nHeaderLength);
+  message.SerializeWithCachedSizesToArray(pBuffer + nHeaderLength);
   return m_pChannel
       && m_pChannel->send(nSessionId, BinaryMessage(buffer.data(), buffer.size()));
 }
 
+template<typename FrameType>
+bool ProtobufChannel<FrameType>::sendSerialized(
+    uint32_t nSessionId, std::string const& body, FrameType const& header)
+{
+  if (!m_pChannel) {
+    return false;
+  }
+  // Both tag and length of the batch are 32-bit varints (up to 5 bytes each)
+  uint8_t      batchHeader[10];
+  const size_t nHeaderLength      = header.ByteSizeLong();
+  const size_t nMessageLength     = body.size() + nHeaderLength;
+  const size_t nBatchHeaderLength =
+      m_nBatchTag ? writeBatchHeader(batchHeader, nMessageLength) : 0;
+  const size_t nLength            = nBatchHeaderLength + nMessageLength;
+  auto fWrite = [&](uint8_t* pBuffer) {
+    memcpy(pBuffer, batchHeader, nBatchHeaderLength);
+    pBuffer += nBatchHeaderLength;
+    memcpy(pBuffer, body.data(), body.size());
+    header.SerializeWithCachedSizesToArray(pBuffer + body.size());
+  };
+
+  if (m_pUdpSocket) {
+    // The body is copied once, right into the socket's chunk
+    return m_pUdpSocket->sendInPlace(nSessionId, nLength, fWrite);
+  }
+
+  std::string buffer(nLength, '\0');
+  fWrite(reinterpret_cast<uint8_t*>(&buffer[0]));
+  return m_pChannel->send(nSessionId, BinaryMessage(buffer.data(), buffer.size()));
+}
+
 template<typename FrameType>
 void ProtobufChannel<FrameType>::attachToTerminal(TerminalPtr pTerminal)
 {
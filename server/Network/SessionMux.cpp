@@ -1,4 +1,5 @@
 #include <Network/SessionMux.h>
+#include <Network/ProtobufChannel.h>
 #include <Utils/Clock.h>
 #include <Utils/RandomSequence.h>
 
@@ -77,12 +78,15 @@ void SessionMux::Socket::onSessionClosed(uint32_t nConnectionId)
 
 void SessionMux::Socket::attachToChannel(IPlayerChannelPtr pChannel)
 {
-  m_pChannel = pChannel;
+  m_pChannel         = pChannel;
+  m_pProtobufChannel =
+      std::dynamic_pointer_cast<ProtobufChannel<spex::Message>>(pChannel);
 }
 
 void SessionMux::Socket::detachFromChannel()
 {
-  m_pChannel = nullptr;
+  m_pChannel         = nullptr;
+  m_pProtobufChannel = nullptr;
 }
 
 bool SessionMux::Socket::send(uint32_t nSessionId, spex::Message&& message)
@@ -102,6 +106,39 @@ bool SessionMux::Socket::send(uint32_t nSessionId, spex::Message&& message)
   return false;
 }
 
+size_t SessionMux::Socket::broadcast(uint32_t const* pSessions, size_t nTotal,
+                                     spex::Message const& message)
+{
+  if (!m_pProtobufChannel) {
+    return IPlayerChannel::broadcast(pSessions, nTotal, message);
+  }
+
+  // The message is serialized once. Only a small header with 'tunnelId' and
+  // 'timestamp' is serialized for every session and appended to the body
+  std::string body;
+  message.SerializeToString(&body);
+  spex::Message header;
+  header.set_timestamp(utils::GlobalClock::now());
+
+  size_t nSent = 0;
+  for (size_t i = 0; i < nTotal; ++i) {
+    const uint32_t nSessionId  = pSessions[i];
+    const uint16_t nSessionIdx = nSessionId >> 16;
+    if (nSessionIdx >= m_pOwner->m_sessions.size()) {
+      continue;
+    }
+    const Session& session = m_pOwner->m_sessions[nSessionIdx];
+    if (session.isValid() && session.sessionId() == nSessionId) {
+      header.set_tunnelid(nSessionId);
+      if (m_pProtobufChannel->sendSerialized(
+            session.m_nConnectionId, body, header)) {
+        ++nSent;
+      }
+    }
+  }
+  return nSent;
+}
+
 void SessionMux::Socket::closeSession(uint32_t nSessionId)
 {
   // A module closes the session
@@ -8,6 +8,7 @@
 
 namespace network {
 
+template<typename FrameType> class ProtobufChannel;
 
 // SessionMux provides a way to forward incoming messages to appropriate
 // handler. Each player has it's own instance of SessionMux. It is shared
@@ -73,6 +74,9 @@ private:
   private:
     SessionMux*       m_pOwner;
     IPlayerChannelPtr m_pChannel;
+    std::shared_ptr<ProtobufChannel<spex::Message>> m_pProtobufChannel;
+      // The same channel as 'm_pChannel', if it is a protobuf channel. Is
+      // used to send a message, serialized once, to several sessions
 
   public:
     Socket(SessionMux* pOwner) : m_pOwner(pOwner) {}
@@ -94,6 +98,8 @@ private:
 
     // Overrides from IPlayerChannel
     bool send(uint32_t nSessionId, spex::Message&& message) override;
+    size_t broadcast(uint32_t const* pSessions, size_t nTotal,
+                     spex::Message const& message) override;
     void closeSession(uint32_t nSessionId) override;
     bool isValid() const override;
     void attachToTerminal(IPlayerTerminalPtr pTerminal) override;
@@ -159,6 +165,9 @@ public:
   uint16_t getStagesCount() override { return 1; }
   bool prephare(uint16_t nStageId, uint32_t nIntervalUs, uint64_t now) override;
   void proceed(uint16_t nStageId, uint32_t nIntervalUs, uint64_t now) override;
+  conveyor::DataAccess getDataAccess() const override {
+    return conveyor::DataAccess(conveyor::eObjectsRegistry, conveyor::eSessions);
+  }
 };
 
 }  // namespace network
\ No newline at end of file
@@ -6,10 +6,26 @@
 namespace network {
 
 UdpDispatcher::UdpDispatcher(boost::asio::io_service& ioContext,
-                             uint16_t nPoolBegin, uint16_t nPoolEnd)
+                             uint16_t nPoolBegin, uint16_t nPoolEnd,
+                             bool lIoThread)
   : m_IOContext(ioContext),
     m_portsPool(nPoolBegin, nPoolEnd)
-{}
+{
+  if (lIoThread) {
+    // Work guard doesn't let 'run()' to return while there are no sockets
+    m_workGuard.emplace(boost::asio::make_work_guard(m_IOContext));
+    m_ioThread = std::thread([this]() { m_IOContext.run(); });
+  }
+}
+
+UdpDispatcher::~UdpDispatcher()
+{
+  if (m_ioThread.joinable()) {
+    m_workGuard.reset();
+    m_IOContext.stop();
+    m_ioThread.join();
+  }
+}
 
 UdpSocketPtr UdpDispatcher::createUdpSocket(
   uint16_t nLocalPort, bool lPromiscMode)
@@ -21,12 +37,47 @@ UdpSocketPtr UdpDispatcher::createUdpSocket(
     if (!nLocalPort)
       return UdpSocketPtr();
   }
-  return std::make_shared<UdpSocket>(m_IOContext, nLocalPort, lPromiscMode);
+  UdpSocketPtr pSocket = std::make_shared<UdpSocket>(
+        m_IOContext, nLocalPort, lPromiscMode, m_ioThread.joinable());
+  pSocket->enableBatchedSending();
+  m_sockets.push_back(pSocket);
+  return pSocket;
+}
+
+void UdpDispatcher::flush()
+{
+  std::lock_guard<utils::Mutex> guard(m_Mutex);
+  for (size_t i = 0; i < m_sockets.size();) {
+    UdpSocketPtr pSocket = m_sockets[i].lock();
+    if (!pSocket) {
+      std::swap(m_sockets[i], m_sockets.back());
+      m_sockets.pop_back();
+      continue;
+    }
+    pSocket->flush();
+    ++i;
+  }
 }
 
 bool UdpDispatcher::prephare(uint16_t, uint32_t, uint64_t)
 {
-  while(m_IOContext.poll());
+  if (!m_ioThread.joinable()) {
+    while(m_IOContext.poll());
+    return false;
+  }
+
+  // Datagrams have been already received by the I/O thread. Terminals may
+  // create new sockets, so they are called without the mutex being locked.
+  std::vector<UdpSocketWeakPtr> sockets;
+  {
+    std::lock_guard<utils::Mutex> guard(m_Mutex);
+    sockets = m_sockets;
+  }
+  for (UdpSocketWeakPtr const& pWeakSocket: sockets) {
+    if (UdpSocketPtr pSocket = pWeakSocket.lock()) {
+      pSocket->deliverReceived();
+    }
+  }
   return false;
 }
 
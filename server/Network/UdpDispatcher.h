@@ -3,6 +3,9 @@
 #include <boost/asio.hpp>
 
 #include <atomic>
+#include <optional>
+#include <thread>
+#include <vector>
 #include <Conveyor/IAbstractLogic.h>
 #include <Utils/SimpleIdPool.h>
 #include <Utils/Mutex.h>
@@ -18,22 +21,44 @@ class UdpDispatcher : public conveyor::IAbstractLogic
 { 
 public:
   UdpDispatcher(boost::asio::io_service& ioContext,
-                uint16_t nPoolBegin, uint16_t nPoolEnd);
+                uint16_t nPoolBegin, uint16_t nPoolEnd,
+                bool lIoThread = false);
+    // If 'lIoThread' is true, 'ioContext' is run by a dedicated I/O thread
+    // (from now until the dispatcher is destroyed), which receives datagrams
+    // and completes asynchronous sends. Received datagrams are handed to
+    // terminals by the conveyor, at the beginning of the tick. Otherwise
+    // 'ioContext' is polled by the conveyor.
+  ~UdpDispatcher() override;
 
   UdpSocketPtr createUdpSocket(uint16_t nLocalPort = 0, 
                                bool lPromiscMode = false);
 
+  void flush();
+    // Send all messages, that have been queued by sockets during the tick.
+    // Should be called when the tick is over (sockets, created by the
+    // dispatcher, work in batched mode, see UdpSocket::enableBatchedSending())
+
   // overrides from IAbstractLogic interface
   uint16_t getStagesCount() override { return 1; }
   bool     prephare(uint16_t nStageId, uint32_t nIntervalUs, uint64_t now) override;
   void     proceed(uint16_t nStageId, uint32_t nIntervalUs, uint64_t) override;
 
   size_t   getCooldownTimeUs() const override { return 0; }
+  conveyor::DataAccess getDataAccess() const override {
+    return conveyor::DataAccess(conveyor::eNoData,
+                                conveyor::eSessions | conveyor::eInbox);
+  }
 
 private:
   boost::asio::io_service& m_IOContext;
 
   utils::SimpleIdPool<uint16_t, 0> m_portsPool;
+  std::vector<UdpSocketWeakPtr>    m_sockets;
+
+  using WorkGuard =
+      boost::asio::executor_work_guard<boost::asio::io_context::executor_type>;
+  std::optional<WorkGuard> m_workGuard;
+  std::thread              m_ioThread;
 
   utils::Mutex       m_Mutex;
 };
@@ -1,29 +1,76 @@
 #include "UdpSocket.h"
 
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <string_view>
 #include <boost/array.hpp>
+#ifdef __linux__
+#include <errno.h>
+#include <limits.h>
+#endif
 
 namespace network {
 
 constexpr size_t nPersistentSessionsLimit = 16;
 constexpr size_t nSessionsLimit           = 512;
-constexpr size_t nReceiveBufferSize       = 8196;
 
 UdpSocket::UdpSocket(boost::asio::io_service &io_context,
                      uint16_t                 nLocalPort,
-                     bool                     lPromiscMode)
-  : m_socket(io_context, udp::endpoint(udp::v4(), nLocalPort)),
+                     bool                     lPromiscMode,
+                     bool                     lIoThreadMode)
+  : m_ioContext(io_context),
+    m_socket(io_context, udp::endpoint(udp::v4(), nLocalPort)),
     m_lPromiscMode(lPromiscMode),
     m_sessions(nSessionsLimit),
-    m_pReceiveBuffer(nReceiveBufferSize)
+    m_pReceiveBuffer(nReceiveBatchSize * nReceiveBufferSize),
+    // Every outgoing message is written to a chunk, so most of chunks are
+    // small, while coalesced datagrams may need the biggest ones
+    m_ChunksPool({utils::ChunksPool::SizeClass{256, 1024},
+                  utils::ChunksPool::SizeClass{512, 256},
+                  utils::ChunksPool::SizeClass{nMaxDatagramSize, 64}}),
+    m_lIoThreadMode(lIoThreadMode)
 {
+#ifdef __linux__
+  for (size_t i = 0; i < nReceiveBatchSize; ++i) {
+    m_receiveIovecs[i].iov_base = m_pReceiveBuffer.data() + i * nReceiveBufferSize;
+    m_receiveIovecs[i].iov_len  = nReceiveBufferSize;
+  }
+#endif
   boost::asio::socket_base::reuse_address optReuseAddr(true);
   m_socket.set_option(optReuseAddr);
+  if (m_lPromiscMode) {
+    // Sessions with lower ids are taken first
+    for (size_t i = nSessionsLimit; i > nPersistentSessionsLimit; --i) {
+      m_freeSessions.push_back(static_cast<uint32_t>(i - 1));
+    }
+  }
   receivingData();
 }
 
 UdpSocket::~UdpSocket()
 {
-  m_socket.close();
+  if (m_lIoThreadMode && !m_ioContext.stopped()) {
+    // Socket should be closed by the I/O thread, since it may be used by it
+    // right now. Handlers of the sends, aborted by closing, are called by the
+    // I/O thread as well, so the socket should outlive the last of them.
+    std::future<void> completed = m_sendsCompleted.get_future();
+    boost::asio::post(m_ioContext, [this]() {
+      m_socket.close();
+      m_lClosed = true;
+      if (m_nPendingSends == 0) {
+        m_sendsCompleted.set_value();
+      }
+    });
+    completed.wait();
+  } else {
+    m_socket.close();
+    // Handlers of the pending sends are called by whoever polls the context
+    while (m_nPendingSends && m_ioContext.poll_one());
+  }
+  for (QueuedMessage const& item: m_queue) {
+    m_ChunksPool.release(item.m_pChunk);
+  }
 }
 
 std::optional<uint32_t>
@@ -35,7 +82,9 @@ UdpSocket::createPersistentSession(udp::endpoint const& remote)
         m_pTerminal->canOpenSession())
     {
       m_pTerminal->openSession(i);
+      std::lock_guard<utils::Mutex> guard(m_Mutex);
       m_sessions[i] = remote;
+      m_persistentSessions.emplace(remote, i);
       std::cout << "Persistant session #" << i << " created" << std::endl;
       return i;
     }
@@ -60,99 +109,358 @@ void UdpSocket::attachToTerminal(IBinaryTerminalPtr pTerminal)
 
 bool UdpSocket::send(uint32_t nSessionId, BinaryMessage&& message)
 {
-  std::lock_guard<utils::Mutex> guard(m_Mutex);
+  return sendInPlace(nSessionId, message.m_nLength,
+                     [&message](uint8_t* pBuffer) {
+                       memcpy(pBuffer, message.m_pBody, message.m_nLength);
+                     });
+}
 
-  if (nSessionId >= m_sessions.size()) {
+bool UdpSocket::sendChunk(uint32_t nSessionId, uint8_t* pChunk, size_t nLength)
+{
+  std::lock_guard<utils::Mutex> guard(m_Mutex);
+  if (nSessionId >= m_sessions.size() ||
+      m_sessions[nSessionId] == udp::endpoint()) {
+    m_ChunksPool.release(pChunk);
     return false;
   }
+
   udp::endpoint const& remote = m_sessions[nSessionId];
-  if (remote == udp::endpoint()) {
-    return false;
+  if (m_lBatchedSending) {
+    m_queue.push_back(QueuedMessage{remote, pChunk, nLength});
+  } else {
+    sendChunkAsync(remote, pChunk, nLength);
   }
 
-  uint8_t* pChunk = m_ChunksPool.get(message.m_nLength);
-  memcpy(pChunk, message.m_pBody, message.m_nLength);
-  m_socket.async_send_to(
-        boost::asio::buffer(pChunk, message.m_nLength), remote,
-        [this, pChunk](const boost::system::error_code&, std::size_t) {
-          m_ChunksPool.release(pChunk);
-        });
-
   if (m_lPromiscMode && nSessionId >= nPersistentSessionsLimit) {
     // In promisc mode, once responce is sent, session should be closed
-    m_sessions[nSessionId] = udp::endpoint();
+    releaseSessionLocked(nSessionId);
   }
   return true;
 }
 
+void UdpSocket::releaseSessionLocked(uint32_t nSessionId)
+{
+  if (nSessionId >= m_sessions.size() ||
+      m_sessions[nSessionId] == udp::endpoint()) {
+    return;
+  }
+  if (nSessionId < nPersistentSessionsLimit) {
+    auto I = m_persistentSessions.find(m_sessions[nSessionId]);
+    if (I != m_persistentSessions.end() && I->second == nSessionId) {
+      m_persistentSessions.erase(I);
+    }
+  } else {
+    m_freeSessions.push_back(nSessionId);
+  }
+  m_sessions[nSessionId] = udp::endpoint();
+}
+
+void UdpSocket::flush()
+{
+  {
+    std::lock_guard<utils::Mutex> guard(m_Mutex);
+    if (m_queue.empty()) {
+      return;
+    }
+    std::swap(m_queue, m_flushing);
+  }
+
+  prephareDatagrams();
+  const size_t nSent = sendBatch();
+  for (size_t i = 0; i < nSent; ++i) {
+    Datagram const& datagram = m_datagrams[i];
+    for (size_t j = 0; j < datagram.m_nTotalParts; ++j) {
+      m_ChunksPool.release(
+            m_flushing[m_parts[datagram.m_nFirstPart + j]].m_pChunk);
+    }
+  }
+  if (nSent < m_datagrams.size()) {
+    // Socket's buffer is full (or batched sending is not supported), so the
+    // rest datagrams are sent asynchronously
+    std::lock_guard<utils::Mutex> guard(m_Mutex);
+    for (size_t i = nSent; i < m_datagrams.size(); ++i) {
+      sendAsync(m_datagrams[i]);
+    }
+  }
+  m_flushing.clear();
+}
+
+void UdpSocket::prephareDatagrams()
+{
+  m_datagrams.clear();
+  m_parts.resize(m_flushing.size());
+  for (size_t i = 0; i < m_flushing.size(); ++i) {
+    m_parts[i] = i;
+  }
+  if (!m_lCoalescing) {
+    for (size_t i = 0; i < m_flushing.size(); ++i) {
+      m_datagrams.push_back(Datagram{i, 1, m_flushing[i].m_nLength});
+    }
+    return;
+  }
+
+  // Messages for the same remote become adjacent, but keep their order
+  std::stable_sort(m_parts.begin(), m_parts.end(),
+                   [this](size_t nLeft, size_t nRight) {
+    return m_flushing[nLeft].m_remote < m_flushing[nRight].m_remote;
+  });
+  for (size_t i = 0; i < m_parts.size(); ++i) {
+    QueuedMessage const& item = m_flushing[m_parts[i]];
+    if (!m_datagrams.empty()) {
+      Datagram& last = m_datagrams.back();
+      if (m_flushing[m_parts[last.m_nFirstPart]].m_remote == item.m_remote
+          && last.m_nLength + item.m_nLength <= nMaxDatagramSize
+          && last.m_nTotalParts < nMaxDatagramParts) {
+        ++last.m_nTotalParts;
+        last.m_nLength += item.m_nLength;
+        continue;
+      }
+    }
+    m_datagrams.push_back(Datagram{i, 1, item.m_nLength});
+  }
+}
+
+void UdpSocket::deliverReceived()
+{
+  {
+    std::lock_guard<utils::Mutex> guard(m_inboxMutex);
+    if (m_inbox.empty()) {
+      return;
+    }
+    std::swap(m_inbox, m_delivering);
+    std::swap(m_inboxData, m_deliveringData);
+  }
+  for (ReceivedMessage const& item: m_delivering) {
+    onDataReceived(item.m_remote, m_deliveringData.data() + item.m_nOffset,
+                   item.m_nLength);
+  }
+  m_delivering.clear();
+  m_deliveringData.clear();
+}
+
 void UdpSocket::closeSession(uint32_t nSessionId)
 {
-  if (nSessionId < m_sessions.size()) {
-    //std::cout << "Close session #" << nSessionId << std::endl;
-    m_sessions[nSessionId] = udp::endpoint();
+  std::lock_guard<utils::Mutex> guard(m_Mutex);
+  releaseSessionLocked(nSessionId);
+}
+
+void UdpSocket::sendAsync(Datagram const& datagram)
+{
+  QueuedMessage const& first = m_flushing[m_parts[datagram.m_nFirstPart]];
+  if (datagram.m_nTotalParts == 1) {
+    sendChunkAsync(first.m_remote, first.m_pChunk, first.m_nLength);
+    return;
+  }
+
+  // Coalesced messages should be gathered into a single chunk
+  uint8_t* pChunk  = m_ChunksPool.get(datagram.m_nLength);
+  size_t   nOffset = 0;
+  for (size_t i = 0; i < datagram.m_nTotalParts; ++i) {
+    QueuedMessage const& item = m_flushing[m_parts[datagram.m_nFirstPart + i]];
+    memcpy(pChunk + nOffset, item.m_pChunk, item.m_nLength);
+    nOffset += item.m_nLength;
+    m_ChunksPool.release(item.m_pChunk);
+  }
+  sendChunkAsync(first.m_remote, pChunk, datagram.m_nLength);
+}
+
+void UdpSocket::sendChunkAsync(udp::endpoint const& remote, uint8_t* pChunk,
+                               size_t nLength)
+{
+  ++m_nPendingSends;
+  auto fSend = [this, pChunk, nLength, remote]() {
+    m_socket.async_send_to(
+          boost::asio::buffer(pChunk, nLength), remote,
+          [this, pChunk](const boost::system::error_code&, std::size_t) {
+            // Pool is thread safe, so m_Mutex is not required here
+            m_ChunksPool.release(pChunk);
+            // In I/O thread mode 'm_lClosed' is changed by the I/O thread
+            // only, so it can't be changed concurrently
+            if (--m_nPendingSends == 0 && m_lClosed) {
+              m_sendsCompleted.set_value();
+            }
+          });
+  };
+  if (m_lIoThreadMode) {
+    boost::asio::post(m_ioContext, std::move(fSend));
+  } else {
+    fSend();
+  }
+}
+
+size_t UdpSocket::sendBatch()
+{
+#ifdef __linux__
+  m_iovecs.resize(m_parts.size());
+  for (size_t i = 0; i < m_parts.size(); ++i) {
+    QueuedMessage const& item = m_flushing[m_parts[i]];
+    m_iovecs[i].iov_base = item.m_pChunk;
+    m_iovecs[i].iov_len  = item.m_nLength;
+  }
+
+  // Parts of every datagram are gathered by the kernel
+  const size_t nTotal = m_datagrams.size();
+  m_headers.resize(nTotal);
+  for (size_t i = 0; i < nTotal; ++i) {
+    Datagram const& datagram = m_datagrams[i];
+    udp::endpoint&  remote   = m_flushing[m_parts[datagram.m_nFirstPart]].m_remote;
+
+    m_headers[i] = mmsghdr();
+    msghdr& header     = m_headers[i].msg_hdr;
+    header.msg_name    = remote.data();
+    header.msg_namelen = static_cast<socklen_t>(remote.size());
+    header.msg_iov     = &m_iovecs[datagram.m_nFirstPart];
+    header.msg_iovlen  = datagram.m_nTotalParts;
+  }
+
+  size_t nSent = 0;
+  while (nSent < nTotal) {
+    const unsigned int nBatchSize =
+        static_cast<unsigned int>(std::min<size_t>(nTotal - nSent, UIO_MAXIOV));
+    const int nResult = ::sendmmsg(m_socket.native_handle(),
+                                   m_headers.data() + nSent, nBatchSize,
+                                   MSG_DONTWAIT);
+    if (nResult > 0) {
+      nSent += static_cast<size_t>(nResult);
+    } else if (nResult < 0 && errno == EINTR) {
+      continue;
+    } else {
+      break;
+    }
   }
+  return nSent;
+#else
+  return 0;
+#endif
 }
 
 void UdpSocket::receivingData()
 {
-  using namespace std::placeholders;
-  m_socket.async_receive_from(
-        boost::asio::buffer(m_pReceiveBuffer.data(), nReceiveBufferSize),
-        m_senderAddress,
-        [this](boost::system::error_code const& error, std::size_t nTotalBytes)
-        {
-          onDataReceived(error, nTotalBytes);
+  // Instead of receiving datagrams one by one, wait until the socket becomes
+  // readable and then read all datagrams, that are waiting in it's buffer
+  m_socket.async_wait(
+        udp::socket::wait_read,
+        [this](boost::system::error_code const& error) {
+          if (error) {
+            // Socket has been closed
+            assert(error == boost::asio::error::operation_aborted
+                   && "unexpected boost.asio error!");
+            return;
+          }
+          onReadyToReceive();
           // Continue receiving data
           receivingData();
         });
 }
 
-void UdpSocket::onDataReceived(boost::system::error_code const& error,
-                               std::size_t nTotalBytes)
+void UdpSocket::onReadyToReceive()
 {
-  if (!error)
-  {
-    std::optional<uint32_t> nSessionId;
-
-    // Linear complicity in searching for sessionId is OK, because in general
-    // we won't have a lot of sessions (nSessionsLimit is just 8)
-    for(size_t i = 0; i < nPersistentSessionsLimit; ++i) {
-      if (m_senderAddress == m_sessions[i]) {
-        nSessionId = i;
-        break;
+  size_t nReceived = 0;
+  do {
+    nReceived = receiveBatch();
+    if (m_lIoThreadMode) {
+      // Datagrams will be handed to the terminal by the conveyor
+      std::lock_guard<utils::Mutex> guard(m_inboxMutex);
+      for (size_t i = 0; i < nReceived; ++i) {
+        uint8_t const* pData = m_pReceiveBuffer.data() + i * nReceiveBufferSize;
+        m_inbox.push_back(ReceivedMessage{
+              m_senders[i], m_inboxData.size(), m_nReceivedBytes[i]});
+        m_inboxData.insert(m_inboxData.end(),
+                           pData, pData + m_nReceivedBytes[i]);
+      }
+    } else {
+      for (size_t i = 0; i < nReceived; ++i) {
+        onDataReceived(m_senders[i],
+                       m_pReceiveBuffer.data() + i * nReceiveBufferSize,
+                       m_nReceivedBytes[i]);
       }
     }
+  } while (nReceived == nReceiveBatchSize);
+}
 
-    if (nSessionId.has_value()) {  // [[likely]]
-      m_pTerminal->onMessageReceived(
-              *nSessionId, BinaryMessage(m_pReceiveBuffer.data(), nTotalBytes));
-
-    } else if (m_lPromiscMode) {
-      //size_t nAlreadyOpened = 0;
-      for(size_t i = nPersistentSessionsLimit; i < m_sessions.size(); ++i) {
-        // To prevent spamming from the same IP:
-        // if (m_senderAddress.address() == m_sessions[i].address()) {
-        //   ++nAlreadyOpened;
-        //   if (nAlreadyOpened == nPersistentSessionsLimit) {
-        //     // Too many simultanious requests from the same IP
-        //     return;
-        //   }
-        // }
-        if (!nSessionId && m_sessions[i] == udp::endpoint()) {
-          nSessionId = i;
-          break;
-        }
-      }
+size_t UdpSocket::receiveBatch()
+{
+#ifdef __linux__
+  for (size_t i = 0; i < nReceiveBatchSize; ++i) {
+    m_receiveHeaders[i] = mmsghdr();
+    msghdr& header     = m_receiveHeaders[i].msg_hdr;
+    header.msg_name    = m_senders[i].data();
+    header.msg_namelen = static_cast<socklen_t>(m_senders[i].capacity());
+    header.msg_iov     = &m_receiveIovecs[i];
+    header.msg_iovlen  = 1;
+  }
 
-      if (nSessionId.has_value()) {
-        m_sessions[*nSessionId] = m_senderAddress;
-        m_pTerminal->onMessageReceived(
-              *nSessionId, BinaryMessage(m_pReceiveBuffer.data(), nTotalBytes));
-      }
+  int nResult = 0;
+  do {
+    nResult = ::recvmmsg(m_socket.native_handle(), m_receiveHeaders.data(),
+                         nReceiveBatchSize, MSG_DONTWAIT, nullptr);
+  } while (nResult < 0 && errno == EINTR);
+  if (nResult <= 0) {
+    return 0;
+  }
+
+  const size_t nReceived = static_cast<size_t>(nResult);
+  for (size_t i = 0; i < nReceived; ++i) {
+    m_senders[i].resize(m_receiveHeaders[i].msg_hdr.msg_namelen);
+    m_nReceivedBytes[i] = m_receiveHeaders[i].msg_len;
+  }
+  return nReceived;
+#else
+  size_t nReceived = 0;
+  boost::system::error_code error;
+  while (nReceived < nReceiveBatchSize && m_socket.available(error) && !error) {
+    m_nReceivedBytes[nReceived] = m_socket.receive_from(
+          boost::asio::buffer(
+            m_pReceiveBuffer.data() + nReceived * nReceiveBufferSize,
+            nReceiveBufferSize),
+          m_senders[nReceived], 0, error);
+    if (error) {
+      break;
     }
-  } else {
-    assert(nullptr == "unexpected boost.asio error!");
+    ++nReceived;
+  }
+  return nReceived;
+#endif
+}
+
+void UdpSocket::onDataReceived(udp::endpoint const& sender,
+                               uint8_t const*       pData,
+                               std::size_t          nTotalBytes)
+{
+  std::optional<uint32_t> nSessionId;
+  {
+    std::lock_guard<utils::Mutex> guard(m_Mutex);
+    auto I = m_persistentSessions.find(sender);
+    if (I != m_persistentSessions.end()) {  // [[likely]]
+      nSessionId = I->second;
+    } else if (m_lPromiscMode && !m_freeSessions.empty()) {
+      nSessionId = m_freeSessions.back();
+      m_freeSessions.pop_back();
+      m_sessions[*nSessionId] = sender;
+    }
+  }
+
+  if (nSessionId.has_value()) {
+    m_pTerminal->onMessageReceived(
+          *nSessionId, BinaryMessage(pData, nTotalBytes));
+  }
+}
+
+size_t UdpSocket::EndpointHash::operator()(udp::endpoint const& endpoint) const
+{
+  boost::asio::ip::address const& address = endpoint.address();
+  if (address.is_v4()) {
+    const uint64_t nKey =
+        (static_cast<uint64_t>(address.to_v4().to_uint()) << 16)
+        | endpoint.port();
+    return std::hash<uint64_t>()(nKey);
   }
+  const boost::asio::ip::address_v6::bytes_type bytes =
+      address.to_v6().to_bytes();
+  const size_t nHash = std::hash<std::string_view>()(
+        std::string_view(reinterpret_cast<char const*>(bytes.data()),
+                         bytes.size()));
+  return nHash ^ (static_cast<size_t>(endpoint.port()) << 1);
 }
 
 } // namespace network
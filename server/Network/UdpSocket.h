@@ -1,12 +1,18 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <future>
 #include <memory>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 #include <optional>
 
 #include <boost/asio.hpp>
+#ifdef __linux__
+#include <sys/socket.h>
+#endif
 
 #include <Utils/ChunksPool.h>
 #include <Utils/Mutex.h>
@@ -21,7 +27,13 @@ class UdpSocket : public IBinaryChannel
 public:
   UdpSocket(boost::asio::io_service& io_context,
             uint16_t                 nLocalPort,
-            bool                     lPromiscMode);
+            bool                     lPromiscMode,
+            bool                     lIoThreadMode = false);
+    // 'lIoThreadMode' should be true if 'io_context' is run by a dedicated I/O
+    // thread. In this mode received datagrams are not handed to the terminal
+    // immediately, but are queued until 'deliverReceived()' is called (so
+    // that the terminal is always called by the conveyor). Asynchronous
+    // operations are initiated by the I/O thread as well.
   UdpSocket(UdpSocket const& other) = delete;
   UdpSocket(UdpSocket&& other)      = delete;
   ~UdpSocket() override;
@@ -40,28 +52,166 @@ public:
   void attachToTerminal(IBinaryTerminalPtr pTerminal) override;
   void detachFromTerminal() override { m_pTerminal.reset(); }
 
+  void enableBatchedSending() { m_lBatchedSending = true; }
+    // In batched mode messages are not sent immediately, but are queued until
+    // 'flush()' is called. All queued messages are sent by a few syscalls.
+  void enableCoalescing() { m_lCoalescing = true; }
+  bool isCoalescing() const { return m_lCoalescing; }
+    // In coalescing mode (works in batched mode only) messages, queued for
+    // the same remote, are concatenated into datagrams up to
+    // 'nMaxDatagramSize' bytes long (keeping their order). The protocol on
+    // top of the socket should be able to split such datagrams (see
+    // ProtobufChannel::enableBatching()).
+  void flush();
+    // Send all queued messages. Should not be called concurrently with
+    // another 'flush()' call.
+
+  void deliverReceived();
+    // Hand all datagrams, queued in I/O thread mode, to the terminal. Should
+    // not be called concurrently with another 'deliverReceived()' call.
+
   // Message pMessage will be copied to internal buffer (probably, without allocation)
   bool send(uint32_t nSessionId, BinaryMessage&& message) override;
+
+  template<typename Writer>
+  bool sendInPlace(uint32_t nSessionId, size_t nLength, Writer&& fWrite);
+    // Send a message of 'nLength' bytes, that is written by 'fWrite(pBuffer)',
+    // so the caller doesn't need a buffer of it's own. The message is written
+    // to a chunk of the socket's pool without locking the socket (all players
+    // share the same socket, so threads should not wait for each other's
+    // encoding). Only the chunk is queued under the lock, so the message is
+    // never copied.
   void closeSession(uint32_t nSessionId) override;
 
 private:
+  struct QueuedMessage {
+    udp::endpoint m_remote;
+    uint8_t*      m_pChunk;
+    size_t        m_nLength;
+  };
+    // Outgoing message; 'm_pChunk' is taken from 'm_ChunksPool'
+
+  struct ReceivedMessage {
+    udp::endpoint m_remote;
+    size_t        m_nOffset;
+    size_t        m_nLength;
+  };
+    // Incoming message, queued in I/O thread mode
+
+  struct Datagram {
+    size_t m_nFirstPart;
+    size_t m_nTotalParts;
+      // Messages of the datagram are m_flushing[m_parts[i]], where 'i' is
+      // in [m_nFirstPart, m_nFirstPart + m_nTotalParts) range
+    size_t m_nLength;
+  };
+
+  struct EndpointHash {
+    size_t operator()(udp::endpoint const& endpoint) const;
+  };
+
+  bool sendChunk(uint32_t nSessionId, uint8_t* pChunk, size_t nLength);
+    // Send (or queue, in batched mode) the message, that has been written to
+    // the 'pChunk', taken from 'm_ChunksPool'. The chunk is owned by the
+    // socket since now, even if there is no such session.
+
+  void releaseSessionLocked(uint32_t nSessionId);
+    // Forget the remote of the specified session, so the session's slot can
+    // be reused (the 'm_Mutex' should be locked)
+  void sendAsync(Datagram const& datagram);
+    // Send a datagram from 'm_datagrams' (m_Mutex should be locked). Chunks
+    // of the datagram's messages are passed to 'sendChunkAsync()' or are
+    // released.
+  void sendChunkAsync(udp::endpoint const& remote, uint8_t* pChunk,
+                      size_t nLength);
+    // Send the 'pChunk', that is taken from 'm_ChunksPool' (m_Mutex should be
+    // locked). The chunk is released when it is sent. The socket is not
+    // destroyed until all such sends are completed (see '~UdpSocket()').
+  void prephareDatagrams();
+    // Split messages from 'm_flushing' into 'm_datagrams'
+  size_t sendBatch();
+    // Send datagrams from 'm_datagrams' with as few syscalls as possible.
+    // Return number of sent datagrams.
+
   void receivingData();
 
-  void onDataReceived(boost::system::error_code const& error, std::size_t nTotalBytes);
+  void onReadyToReceive();
+    // Read all datagrams, that are waiting in the socket's buffer
+  size_t receiveBatch();
+    // Read up to 'nReceiveBatchSize' datagrams into 'm_pReceiveBuffer' and
+    // 'm_senders'. Return number of received datagrams.
+  void onDataReceived(udp::endpoint const& sender,
+                      uint8_t const* pData, std::size_t nTotalBytes);
+public:
+  static constexpr size_t nMaxDatagramSize = 1400;
+    // Coalesced datagrams should fit into ethernet's MTU
+
 private:
+  static constexpr size_t nReceiveBatchSize  = 16;
+  static constexpr size_t nReceiveBufferSize = 8196;
+  static constexpr size_t nMaxDatagramParts  = 64;
 
-  mutable udp::socket m_socket;
-  udp::endpoint       m_senderAddress;
-  bool                m_lPromiscMode;
+  boost::asio::io_service& m_ioContext;
+  mutable udp::socket      m_socket;
+  bool                     m_lPromiscMode;
 
   std::vector<udp::endpoint> m_sessions;
+  std::unordered_map<udp::endpoint, uint32_t, EndpointHash> m_persistentSessions;
+    // Remote -> persistent session, that is associated with it
+  std::vector<uint32_t>      m_freeSessions;
+    // Free slots of promisc sessions (used as a stack)
 
   IBinaryTerminalPtr m_pTerminal;
 
   std::vector<uint8_t>      m_pReceiveBuffer;
+    // Has space for 'nReceiveBatchSize' datagrams, 'nReceiveBufferSize' each
+  std::array<udp::endpoint, nReceiveBatchSize> m_senders;
+  std::array<size_t, nReceiveBatchSize>        m_nReceivedBytes;
+#ifdef __linux__
+  std::array<mmsghdr, nReceiveBatchSize> m_receiveHeaders;
+  std::array<iovec, nReceiveBatchSize>   m_receiveIovecs;
+#endif
   mutable utils::ChunksPool m_ChunksPool;
 
+  bool                       m_lBatchedSending = false;
+  std::vector<QueuedMessage> m_queue;
+  std::vector<QueuedMessage> m_flushing;
+    // Is swapped with 'm_queue' by 'flush()', so new messages may be queued
+    // while the previous ones are being sent
+  bool                       m_lCoalescing = false;
+  std::vector<size_t>        m_parts;
+    // Indexes in 'm_flushing', ordered by datagrams
+  std::vector<Datagram>      m_datagrams;
+#ifdef __linux__
+  std::vector<mmsghdr> m_headers;
+  std::vector<iovec>   m_iovecs;
+#endif
+  std::atomic_size_t         m_nPendingSends{0};
+    // Number of sends, initiated by 'sendChunkAsync()', that have not been
+    // completed yet
+  bool                       m_lClosed = false;
+  std::promise<void>         m_sendsCompleted;
+    // Is set by the I/O thread, when the socket has been closed and all
+    // pending sends have been completed
+
+  bool                       m_lIoThreadMode;
+
+  utils::Mutex                 m_inboxMutex;
+  std::vector<ReceivedMessage> m_inbox;
+  std::vector<uint8_t>         m_inboxData;
+  std::vector<ReceivedMessage> m_delivering;
+  std::vector<uint8_t>         m_deliveringData;
+    // Are swapped with 'm_inbox' and 'm_inboxData' by 'deliverReceived()'
+
   mutable utils::Mutex m_Mutex;
 };
 
+template<typename Writer>
+bool UdpSocket::sendInPlace(uint32_t nSessionId, size_t nLength, Writer&& fWrite)
+{
+  uint8_t* pChunk = m_ChunksPool.get(nLength);
+  fWrite(pChunk);
+  return sendChunk(nSessionId, pChunk, nLength);
+}
+
 } // namespace network
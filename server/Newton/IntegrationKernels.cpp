@@ -0,0 +1,148 @@
+#include "IntegrationKernels.h"
+#include "PhysicsStorage.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define NEWTON_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace newton {
+
+BodiesArrays::BodiesArrays(PhysicsStorage& storage)
+  : x(storage.x.data()), y(storage.y.data()),
+    vx(storage.vx.data()), vy(storage.vy.data()),
+    fx(storage.fx.data()), fy(storage.fy.data()),
+    invMass(storage.invMass.data())
+{}
+
+static void integrateScalar(BodiesArrays const& bodies,
+                            uint32_t nBegin, uint32_t nEnd, double nIntervalSec)
+{
+  double* __restrict x        = bodies.x;
+  double* __restrict y        = bodies.y;
+  double* __restrict vx       = bodies.vx;
+  double* __restrict vy       = bodies.vy;
+  const double* __restrict fx      = bodies.fx;
+  const double* __restrict fy      = bodies.fy;
+  const double* __restrict invMass = bodies.invMass;
+
+  const double nHalfIntervalSec = nIntervalSec * 0.5;
+  for (uint32_t i = nBegin; i < nEnd; ++i) {
+    // acc_t - acceleration * time
+    const double k      = nIntervalSec * invMass[i];
+    const double acc_tx = fx[i] * k;
+    const double acc_ty = fy[i] * k;
+    x[i]  += vx[i] * nIntervalSec + acc_tx * nHalfIntervalSec;
+    y[i]  += vy[i] * nIntervalSec + acc_ty * nHalfIntervalSec;
+    vx[i] += acc_tx;
+    vy[i] += acc_ty;
+  }
+}
+
+#ifdef NEWTON_X86_KERNELS
+
+__attribute__((target("sse2")))
+static void integrateSse2(BodiesArrays const& bodies,
+                          uint32_t nBegin, uint32_t nEnd, double nIntervalSec)
+{
+  const __m128d dt     = _mm_set1_pd(nIntervalSec);
+  const __m128d halfDt = _mm_set1_pd(nIntervalSec * 0.5);
+
+  uint32_t i = nBegin;
+  for (; i + 2 <= nEnd; i += 2) {
+    const __m128d k      = _mm_mul_pd(dt, _mm_loadu_pd(bodies.invMass + i));
+    const __m128d acc_tx = _mm_mul_pd(_mm_loadu_pd(bodies.fx + i), k);
+    const __m128d acc_ty = _mm_mul_pd(_mm_loadu_pd(bodies.fy + i), k);
+    const __m128d vx     = _mm_loadu_pd(bodies.vx + i);
+    const __m128d vy     = _mm_loadu_pd(bodies.vy + i);
+
+    const __m128d dx = _mm_add_pd(_mm_mul_pd(vx, dt), _mm_mul_pd(acc_tx, halfDt));
+    const __m128d dy = _mm_add_pd(_mm_mul_pd(vy, dt), _mm_mul_pd(acc_ty, halfDt));
+    _mm_storeu_pd(bodies.x + i, _mm_add_pd(_mm_loadu_pd(bodies.x + i), dx));
+    _mm_storeu_pd(bodies.y + i, _mm_add_pd(_mm_loadu_pd(bodies.y + i), dy));
+    _mm_storeu_pd(bodies.vx + i, _mm_add_pd(vx, acc_tx));
+    _mm_storeu_pd(bodies.vy + i, _mm_add_pd(vy, acc_ty));
+  }
+  integrateScalar(bodies, i, nEnd, nIntervalSec);
+}
+
+__attribute__((target("avx")))
+static void integrateAvx(BodiesArrays const& bodies,
+                         uint32_t nBegin, uint32_t nEnd, double nIntervalSec)
+{
+  const __m256d dt     = _mm256_set1_pd(nIntervalSec);
+  const __m256d halfDt = _mm256_set1_pd(nIntervalSec * 0.5);
+
+  uint32_t i = nBegin;
+  for (; i + 4 <= nEnd; i += 4) {
+    const __m256d k      = _mm256_mul_pd(dt, _mm256_loadu_pd(bodies.invMass + i));
+    const __m256d acc_tx = _mm256_mul_pd(_mm256_loadu_pd(bodies.fx + i), k);
+    const __m256d acc_ty = _mm256_mul_pd(_mm256_loadu_pd(bodies.fy + i), k);
+    const __m256d vx     = _mm256_loadu_pd(bodies.vx + i);
+    const __m256d vy     = _mm256_loadu_pd(bodies.vy + i);
+
+    const __m256d dx =
+        _mm256_add_pd(_mm256_mul_pd(vx, dt), _mm256_mul_pd(acc_tx, halfDt));
+    const __m256d dy =
+        _mm256_add_pd(_mm256_mul_pd(vy, dt), _mm256_mul_pd(acc_ty, halfDt));
+    _mm256_storeu_pd(bodies.x + i, _mm256_add_pd(_mm256_loadu_pd(bodies.x + i), dx));
+    _mm256_storeu_pd(bodies.y + i, _mm256_add_pd(_mm256_loadu_pd(bodies.y + i), dy));
+    _mm256_storeu_pd(bodies.vx + i, _mm256_add_pd(vx, acc_tx));
+    _mm256_storeu_pd(bodies.vy + i, _mm256_add_pd(vy, acc_ty));
+  }
+  integrateScalar(bodies, i, nEnd, nIntervalSec);
+}
+
+#endif // #ifdef NEWTON_X86_KERNELS
+
+bool isKernelSupported(KernelType eType)
+{
+  switch (eType) {
+    case KernelType::eScalar:
+      return true;
+#ifdef NEWTON_X86_KERNELS
+    case KernelType::eSse2:
+      return __builtin_cpu_supports("sse2");
+    case KernelType::eAvx:
+      return __builtin_cpu_supports("avx");
+#else
+    case KernelType::eSse2:
+    case KernelType::eAvx:
+      return false;
+#endif
+  }
+  return false;
+}
+
+IntegrationKernel getKernel(KernelType eType)
+{
+  if (!isKernelSupported(eType)) {
+    return &integrateScalar;
+  }
+  switch (eType) {
+#ifdef NEWTON_X86_KERNELS
+    case KernelType::eSse2:
+      return &integrateSse2;
+    case KernelType::eAvx:
+      return &integrateAvx;
+#else
+    case KernelType::eSse2:
+    case KernelType::eAvx:
+#endif
+    case KernelType::eScalar:
+      return &integrateScalar;
+  }
+  return &integrateScalar;
+}
+
+KernelType selectBestKernel()
+{
+  for (KernelType eType : {KernelType::eAvx, KernelType::eSse2}) {
+    if (isKernelSupported(eType)) {
+      return eType;
+    }
+  }
+  return KernelType::eScalar;
+}
+
+} // namespace newton
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace newton {
+
+class PhysicsStorage;
+
+// Pointers to arrays, that are proceeded by integration kernels
+// (see PhysicsStorage)
+struct BodiesArrays
+{
+  BodiesArrays() = default;
+  BodiesArrays(PhysicsStorage& storage);
+
+  double*       x       = nullptr;
+  double*       y       = nullptr;
+  double*       vx      = nullptr;
+  double*       vy      = nullptr;
+  double const* fx      = nullptr;
+  double const* fy      = nullptr;
+  double const* invMass = nullptr;
+};
+
+// Kernel integrates a motion of bodies in range [nBegin, nEnd) during the
+// specified 'nIntervalSec':
+//   position += velocity * dt + acceleration * dt^2 / 2
+//   velocity += acceleration * dt
+// All kernels perform the same arithmetic operations in the same order, so
+// they produce the same results.
+using IntegrationKernel = void (*)(BodiesArrays const& bodies,
+                                   uint32_t nBegin, uint32_t nEnd,
+                                   double nIntervalSec);
+
+enum class KernelType {
+  eScalar,
+  eSse2,
+    // 2 bodies per instruction
+  eAvx,
+    // 4 bodies per instruction
+};
+
+bool isKernelSupported(KernelType eType);
+  // Return true if the specified kernel has been built and it is supported
+  // by the CPU
+
+IntegrationKernel getKernel(KernelType eType);
+  // Return the specified kernel. If kernel is not supported, scalar kernel
+  // will be returned.
+
+KernelType selectBestKernel();
+  // Return the fastest kernel, that is supported by the CPU
+
+} // namespace newton
@@ -7,52 +7,128 @@
 namespace newton
 {
 
-using AllObjects = utils::GlobalContainer<PhysicalObject>;
+NewtonEngine::NewtonEngine()
+  : m_fIntegrate(getKernel(selectBestKernel()))
+{}
 
-bool NewtonEngine::prephare(uint16_t, uint32_t, uint64_t)
+bool NewtonEngine::prephare(uint16_t nStageId, uint32_t, uint64_t now)
 {
-  m_nNextObjectId.store(0);
-  return true;
+  PhysicsStorage& storage = PhysicsStorage::instance();
+  switch (nStageId) {
+    case eStageIntegrate: {
+      // Objects, that have been tracked on the previous tick, should be
+      // scheduled again
+      for (uint32_t nObjectId : m_crossingObjects) {
+        storage.schedule(nObjectId);
+      }
+      m_crossingObjects.clear();
+      storage.setNow(now);
+      m_nNextObjectId.store(0);
+      return true;
+    }
+    case eStageTrack: {
+      storage.popCrossings(m_crossingObjects);
+      m_newCells.assign(m_crossingObjects.size(), nullptr);
+      m_nNextObjectId.store(0);
+      return !m_crossingObjects.empty();
+    }
+    case eStageCommit: {
+      commitCrossings();
+      return false;
+    }
+    default:
+      return false;
+  }
 }
 
-void NewtonEngine::proceed(uint16_t, uint32_t nIntervalUs, uint64_t)
+void NewtonEngine::proceed(uint16_t nStageId, uint32_t nIntervalUs, uint64_t)
+{
+  switch (nStageId) {
+    case eStageIntegrate:
+      integrateAll(nIntervalUs);
+      return;
+    case eStageTrack:
+      trackCrossingObjects();
+      return;
+    default:
+      return;
+  }
+}
+
+void NewtonEngine::integrateAll(uint32_t nIntervalUs)
 {
   const uint32_t step         = 64;
   const double   nIntervalSec = nIntervalUs / 1000000.0;
 
+  PhysicsStorage&    storage = PhysicsStorage::instance();
+  const BodiesArrays bodies(storage);
+  const uint32_t     nTotal  = storage.size();
+
   uint32_t begin = m_nNextObjectId.fetch_add(step);
-  while (begin < AllObjects::Size()) {
-    const uint32_t end = std::min(begin + step, AllObjects::Size());
-    for (uint32_t nId = begin; nId < end; ++nId) {
-      PhysicalObject* pObject = AllObjects::Instance(nId);
-      if (pObject) {
-        // acc_t - acceleration * time
-        geometry::Vector acc_t;
-        for (geometry::Vector const& externalForce : pObject->m_externalForces)
-          acc_t += externalForce;
-        acc_t *= nIntervalSec/pObject->m_weight;
-
-        geometry::Vector movement(pObject->m_velocity, nIntervalSec);
-        movement.add(acc_t, nIntervalSec * 0.5);
-        pObject->m_position.translate(movement);
-        pObject->m_velocity += acc_t;
-
-        if (pObject->m_pCell) {
-          pObject->m_pCell = pObject->m_pCell->track(
-                pObject->getInstanceId(),
-                pObject->m_position.x,
-                pObject->m_position.y);
-        } else {
-          pObject->m_pCell = world::Grid::getGlobal()->add(
-                pObject->getInstanceId(),
-                pObject->m_position.x,
-                pObject->m_position.y);
-        }
-      }
+  while (begin < nTotal) {
+    const uint32_t end = std::min(begin + step, nTotal);
+    m_fIntegrate(bodies, begin, end, nIntervalSec);
+    begin = m_nNextObjectId.fetch_add(step);
+  }
+}
+
+void NewtonEngine::trackCrossingObjects()
+{
+  const uint32_t step = 64;
+
+  PhysicsStorage& storage = PhysicsStorage::instance();
+  world::Grid*    pGrid   = world::Grid::getGlobal();
+  const uint32_t  nTotal  = static_cast<uint32_t>(m_crossingObjects.size());
+
+  uint32_t begin = m_nNextObjectId.fetch_add(step);
+  while (begin < nTotal) {
+    const uint32_t end = std::min(begin + step, nTotal);
+    for (uint32_t i = begin; i < end; ++i) {
+      const uint32_t         nId      = m_crossingObjects[i];
+      const geometry::Point  position = storage.getPosition(nId);
+      world::Cell const*     pCell    = storage.cells[nId];
+      world::Cell*           pNewCell = pCell
+          ? pCell->destination(position.x, position.y)
+          : pGrid->getCell(position.x, position.y);
+      m_newCells[i] = pNewCell;
+      storage.updateLeaveCellTime(nId, pNewCell);
     }
     begin = m_nNextObjectId.fetch_add(step);
   }
 }
 
+void NewtonEngine::commitCrossings()
+{
+  PhysicsStorage& storage = PhysicsStorage::instance();
+  world::Grid*    pGrid   = world::Grid::getGlobal();
+  for (size_t i = 0; i < m_newCells.size(); ++i) {
+    const uint32_t nId      = m_crossingObjects[i];
+    world::Cell*&  pCell    = storage.cells[nId];
+    world::Cell*   pNewCell = m_newCells[i];
+    if (!pNewCell) {
+      // Object may have got into the outer cell, that doesn't exist yet
+      const geometry::Point position = storage.getPosition(nId);
+      pNewCell = pGrid->obtainCell(position.x, position.y);
+      storage.updateLeaveCellTime(nId, pNewCell);
+    }
+    if (pCell != pNewCell) {
+      pGrid->move(nId, pCell, pNewCell, storage.getType(nId));
+      pCell = pNewCell;
+    }
+  }
+  m_newCells.clear();
+
+  if (pGrid) {
+    // Objects of dense clusters are moved to smaller cells, so they should
+    // be re-tracked with the new cells' borders
+    pGrid->splitOverfilledCells(
+          [&storage](uint32_t nId) { return storage.getPosition(nId); },
+          [&storage](uint32_t nId, world::Cell* pNewCell) {
+            storage.cells[nId] = pNewCell;
+            storage.updateLeaveCellTime(nId);
+            storage.schedule(nId);
+          });
+  }
+}
 
 } // namespace newton
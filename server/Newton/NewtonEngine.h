@@ -4,24 +4,55 @@
 #include <vector>
 #include <atomic>
 #include "PhysicalObject.h"
+#include "IntegrationKernels.h"
 #include <Utils/Mutex.h>
 #include <Conveyor/IAbstractLogic.h>
 
+namespace world {
+class Cell;
+}
+
 namespace newton {
 
 class NewtonEngine : public conveyor::IAbstractLogic
 {
+  enum Stages {
+    eStageIntegrate = 0,
+    eStageTrack     = 1,
+    eStageCommit    = 2,
+    eTotalStages    = 3
+  };
+
 public:
+  NewtonEngine();
+
   // overrides from IAbstractLogic interface
-  uint16_t getStagesCount() override { return 1; }
+  uint16_t getStagesCount() override { return eTotalStages; }
   bool prephare(uint16_t nStageId, uint32_t nIntervalUs, uint64_t now) override;
   void proceed(uint16_t nStageId, uint32_t nIntervalUs, uint64_t now) override;
   size_t getCooldownTimeUs() const override { return 0; }
+  conveyor::DataAccess getDataAccess() const override {
+    return conveyor::DataAccess(conveyor::eObjectsRegistry, conveyor::ePhysics);
+  }
+
+private:
+  void integrateAll(uint32_t nIntervalUs);
+  void trackCrossingObjects();
+    // Find new cells of objects, that may have left their cells. Grid is
+    // not modified here, so any number of threads may do it simultaneously
+  void commitCrossings();
+    // Move crossing objects to their new cells (creating outer cells, if
+    // required) and split overfilled cells. Is called by a single thread
 
 private:
-  utils::Mutex m_Mutex;
+  utils::Mutex      m_Mutex;
+  IntegrationKernel m_fIntegrate;
+    // The fastest kernel, that is supported by CPU
 
-  std::atomic_size_t m_nNextObjectId;
+  std::atomic_size_t    m_nNextObjectId;
+  std::vector<uint32_t> m_crossingObjects;
+  std::vector<world::Cell*> m_newCells;
+    // New cell of every object in 'm_crossingObjects' (with the same index)
 };
 
 using NewtonEnginePtr = std::shared_ptr<NewtonEngine>;
@@ -9,30 +9,52 @@ DECLARE_GLOBAL_CONTAINER_CPP(newton::PhysicalObject);
 namespace newton {
 
 PhysicalObject::PhysicalObject(double weight, double radius)
-  : m_radius(radius), m_pCell(nullptr)
+  : m_radius(radius)
 {
+  PhysicsStorage::instance().allocate(getInstanceId());
+  PhysicsStorage::instance().updateMaxRadius(radius);
   GlobalObject<PhysicalObject>::registerSelf(this);
   setWeight(weight);
   m_externalForces.reserve(4);
 }
 
+PhysicalObject::~PhysicalObject()
+{
+  PhysicsStorage::instance().release(getInstanceId());
+}
+
 bool PhysicalObject::loadState(YAML::Node const& data, LoadMask mask)
 {
   utils::YamlReader reader(data);
-  if (mask.nValue & LoadMask::eLoadPosition)
-    reader.read("position", m_position);
-  if (mask.nValue & LoadMask::eLoadVelocity)
-    reader.read("velocity", m_velocity);
-  if (mask.nValue & LoadMask::eLoadWeight)
+  if (mask.nValue & LoadMask::eLoadPosition) {
+    geometry::Point position = getPosition();
+    reader.read("position", position);
+    moveTo(position);
+  }
+  if (mask.nValue & LoadMask::eLoadVelocity) {
+    geometry::Vector velocity = getVelocity();
+    reader.read("velocity", velocity);
+    setVelocity(velocity);
+  }
+  if (mask.nValue & LoadMask::eLoadWeight) {
     reader.read("weight", m_weight);
-  if (mask.nValue & LoadMask::eLoadRadius)
+    updateInvMass();
+  }
+  if (mask.nValue & LoadMask::eLoadRadius) {
     reader.read("radius", m_radius);
+    PhysicsStorage::instance().updateMaxRadius(m_radius);
+  }
   return reader.isOk();
 }
 
 void PhysicalObject::moveTo(geometry::Point const& position)
 {
-  m_position = position;
+  PhysicsStorage::instance().moveTo(getInstanceId(), position);
+}
+
+void PhysicalObject::setVelocity(geometry::Vector const& velocity)
+{
+  PhysicsStorage::instance().setVelocity(getInstanceId(), velocity);
 }
 
 void PhysicalObject::changeWeight(double delta)
@@ -40,16 +62,17 @@ void PhysicalObject::changeWeight(double delta)
   std::lock_guard<utils::Spinlock> guard(m_spinlock);
   if (delta < 0 && m_weight < -delta) {
     m_weight = m_minimalWeight;
-    return;
+  } else {
+    m_weight += delta;
+    if (m_weight < m_minimalWeight)
+      m_weight = m_minimalWeight;
   }
-  m_weight += delta;
-  if (m_weight < m_minimalWeight)
-    m_weight = m_minimalWeight;
+  updateInvMass();
 }
 
 double PhysicalObject::getDistanceTo(PhysicalObject const* other)
 {
-  double distance = m_position.distance(other->m_position);
+  double distance = getPosition().distance(other->getPosition());
   distance -= std::min(distance, m_radius);
   distance -= std::min(distance, other->m_radius);
   return distance;
@@ -62,4 +85,25 @@ size_t PhysicalObject::createExternalForce()
   return m_externalForces.size() - 1;
 }
 
+void PhysicalObject::setExternalForce(size_t nForceId,
+                                      geometry::Vector const& force)
+{
+  std::lock_guard<utils::Spinlock> guard(m_spinlock);
+  m_externalForces[nForceId] = force;
+
+  geometry::Vector total;
+  for (geometry::Vector const& externalForce : m_externalForces)
+    total += externalForce;
+  PhysicsStorage& storage = PhysicsStorage::instance();
+  storage.fx[getInstanceId()] = total.getX();
+  storage.fy[getInstanceId()] = total.getY();
+  // Objects without forces are moved on rails (see PhysicsStorage)
+  if (total.getX() == 0 && total.getY() == 0) {
+    storage.putOnRails(getInstanceId());
+  } else {
+    storage.takeOffRails(getInstanceId());
+  }
+  storage.reschedule(getInstanceId());
+}
+
 } // namespace newton
@@ -10,13 +10,13 @@
 #include <Geometry/Vector.h>
 #include <Utils/YamlForwardDeclarations.h>
 #include <World/ObjectTypes.h>
-
-namespace world {
-class Cell;
-}
+#include "PhysicsStorage.h"
 
 namespace newton {
 
+// NOTE: position, velocity, weight and a sum of all external forces of the
+// object are stored in PhysicsStorage; PhysicalObject is just a handle to it.
+
 class PhysicalObject : public utils::GlobalObject<PhysicalObject>
 {
   friend class NewtonEngine;
@@ -42,7 +42,7 @@ public:
 
 public:
   PhysicalObject(double weight, double radius);
-  virtual ~PhysicalObject() = default;
+  virtual ~PhysicalObject();
 
   bool loadState(YAML::Node const& source, LoadMask mask = LoadMask().loadAll());
 
@@ -54,17 +54,24 @@ public:
     return getType() == expectedType;
   }
 
-  double                  getWeight()   const { return m_weight;   }
-  double                  getRadius()   const { return m_radius;   }
-  geometry::Point  const& getPosition() const { return m_position; }
-  geometry::Vector const& getVelocity() const { return m_velocity; }
+  double getWeight() const { return m_weight; }
+  double getRadius() const { return m_radius; }
+
+  geometry::Point getPosition() const {
+    return PhysicsStorage::instance().getPosition(getInstanceId());
+  }
+
+  geometry::Vector getVelocity() const {
+    return PhysicsStorage::instance().getVelocity(getInstanceId());
+  }
 
   void moveTo(geometry::Point const& position);
-  void setVelocity(geometry::Vector const& velocity) { m_velocity = velocity; }
+  void setVelocity(geometry::Vector const& velocity);
   void changeWeight(double delta);
   void setWeight(double weight) {
     std::lock_guard<utils::Spinlock> guard(m_spinlock);
     m_weight = weight < m_minimalWeight ? m_minimalWeight : weight;
+    updateInvMass();
   }
 
   void setRadius(double radius)
@@ -72,6 +79,7 @@ public:
     assert(radius > 0);
     std::lock_guard<utils::Spinlock> guard(m_spinlock);
     m_radius = radius;
+    PhysicsStorage::instance().updateMaxRadius(radius);
   }
 
   double getDistanceTo(PhysicalObject const* other);
@@ -81,17 +89,20 @@ public:
   // 1. The less forces you create, the better perfomance;
   // 2. you should store created force and change it when it is necessary.
   size_t createExternalForce();
-  geometry::Vector& getExternalForce_NoSync(size_t nForceId)
-  { return m_externalForces[nForceId]; }
-  geometry::Vector const& getExternalForce_NoSync(size_t nForceId) const
+  geometry::Vector const& getExternalForce(size_t nForceId) const
   { return m_externalForces[nForceId]; }
+  void setExternalForce(size_t nForceId, geometry::Vector const& force);
+
+private:
+  void updateInvMass() {
+    PhysicsStorage& storage = PhysicsStorage::instance();
+    storage.invMass[getInstanceId()] = 1 / m_weight;
+    storage.reschedule(getInstanceId());
+  }
 
 private:
   double           m_weight;
   double           m_radius;
-  geometry::Point  m_position;
-  geometry::Vector m_velocity;
-  world::Cell*     m_pCell;
   utils::Spinlock  m_spinlock;
 
   // Number of external forces
@@ -0,0 +1,264 @@
+#include "PhysicsStorage.h"
+
+#include <mutex>  // for std::lock_guard
+#include <algorithm>
+#include <limits>
+#include <math.h>
+#include <World/Grid.h>
+
+namespace newton {
+
+PhysicsStorage& PhysicsStorage::instance()
+{
+  static PhysicsStorage storage;
+  return storage;
+}
+
+void PhysicsStorage::allocate(uint32_t nObjectId)
+{
+  std::lock_guard<utils::Mutex> guard(m_mutex);
+  if (nObjectId >= x.size()) {
+    const size_t nNewSize = nObjectId + 1;
+    x.resize(nNewSize, 0);
+    y.resize(nNewSize, 0);
+    vx.resize(nNewSize, 0);
+    vy.resize(nNewSize, 0);
+    fx.resize(nNewSize, 0);
+    fy.resize(nNewSize, 0);
+    invMass.resize(nNewSize, 0);
+    cells.resize(nNewSize, nullptr);
+    alive.resize(nNewSize, 0);
+    ownerId.resize(nNewSize, 0);
+    type.resize(nNewSize, 0);
+    onRails.resize(nNewSize, 0);
+    railVx.resize(nNewSize, 0);
+    railVy.resize(nNewSize, 0);
+    railT0.resize(nNewSize, 0);
+    leaveCellAt.resize(nNewSize, eNever);
+  }
+  x[nObjectId]           = 0;
+  y[nObjectId]           = 0;
+  vx[nObjectId]          = 0;
+  vy[nObjectId]          = 0;
+  fx[nObjectId]          = 0;
+  fy[nObjectId]          = 0;
+  invMass[nObjectId]     = 0;
+  cells[nObjectId]       = nullptr;
+  alive[nObjectId]       = 1;
+  ownerId[nObjectId]     = 0;
+  type[nObjectId]        =
+      static_cast<uint8_t>(world::ObjectType::ePhysicalObject);
+  onRails[nObjectId]     = 1;
+  railVx[nObjectId]      = 0;
+  railVy[nObjectId]      = 0;
+  railT0[nObjectId]      = m_nNowUs;
+  reschedule(nObjectId);
+}
+
+void PhysicsStorage::release(uint32_t nObjectId)
+{
+  std::lock_guard<utils::Mutex> guard(m_mutex);
+  if (nObjectId < x.size()) {
+    vx[nObjectId]          = 0;
+    vy[nObjectId]          = 0;
+    fx[nObjectId]          = 0;
+    fy[nObjectId]          = 0;
+    cells[nObjectId]       = nullptr;
+    alive[nObjectId]       = 0;
+    ownerId[nObjectId]     = 0;
+    type[nObjectId]        = 0;
+    onRails[nObjectId]     = 0;
+    leaveCellAt[nObjectId] = eNever;
+  }
+}
+
+void PhysicsStorage::setNow(uint64_t nNowUs)
+{
+  if (nNowUs < m_nNowUs) {
+    for (uint32_t nObjectId = 0; nObjectId < size(); ++nObjectId) {
+      if (onRails[nObjectId]) {
+        const geometry::Point position = getPosition(nObjectId);
+        x[nObjectId]      = position.x;
+        y[nObjectId]      = position.y;
+        railT0[nObjectId] = nNowUs;
+      }
+    }
+    // All scheduled crossings are in the future now
+    m_crossings = decltype(m_crossings)();
+    m_nNowUs    = nNowUs;
+    for (uint32_t nObjectId = 0; nObjectId < size(); ++nObjectId) {
+      if (alive[nObjectId]) {
+        reschedule(nObjectId);
+      }
+    }
+  }
+  m_nNowUs = nNowUs;
+}
+
+geometry::Point PhysicsStorage::getPosition(uint32_t nObjectId) const
+{
+  if (onRails[nObjectId]) {
+    const double dt = railTimeSec(nObjectId);
+    return geometry::Point(x[nObjectId] + railVx[nObjectId] * dt,
+                           y[nObjectId] + railVy[nObjectId] * dt);
+  }
+  return geometry::Point(x[nObjectId], y[nObjectId]);
+}
+
+geometry::Vector PhysicsStorage::getVelocity(uint32_t nObjectId) const
+{
+  return onRails[nObjectId]
+      ? geometry::Vector(railVx[nObjectId], railVy[nObjectId])
+      : geometry::Vector(vx[nObjectId], vy[nObjectId]);
+}
+
+void PhysicsStorage::moveTo(uint32_t nObjectId, geometry::Point const& position)
+{
+  x[nObjectId] = position.x;
+  y[nObjectId] = position.y;
+  if (onRails[nObjectId]) {
+    railT0[nObjectId] = m_nNowUs;
+  }
+  reschedule(nObjectId);
+}
+
+void PhysicsStorage::setVelocity(uint32_t nObjectId,
+                                 geometry::Vector const& velocity)
+{
+  if (onRails[nObjectId]) {
+    const geometry::Point position = getPosition(nObjectId);
+    x[nObjectId]           = position.x;
+    y[nObjectId]           = position.y;
+    railT0[nObjectId]      = m_nNowUs;
+    railVx[nObjectId]      = velocity.getX();
+    railVy[nObjectId]      = velocity.getY();
+  } else {
+    vx[nObjectId] = velocity.getX();
+    vy[nObjectId] = velocity.getY();
+  }
+  reschedule(nObjectId);
+}
+
+void PhysicsStorage::putOnRails(uint32_t nObjectId)
+{
+  if (onRails[nObjectId]) {
+    return;
+  }
+  railVx[nObjectId]      = vx[nObjectId];
+  railVy[nObjectId]      = vy[nObjectId];
+  railT0[nObjectId]      = m_nNowUs;
+  vx[nObjectId]          = 0;
+  vy[nObjectId]          = 0;
+  onRails[nObjectId]     = 1;
+}
+
+void PhysicsStorage::takeOffRails(uint32_t nObjectId)
+{
+  if (!onRails[nObjectId]) {
+    return;
+  }
+  const geometry::Point position = getPosition(nObjectId);
+  x[nObjectId]           = position.x;
+  y[nObjectId]           = position.y;
+  vx[nObjectId]          = railVx[nObjectId];
+  vy[nObjectId]          = railVy[nObjectId];
+  onRails[nObjectId]     = 0;
+}
+
+void PhysicsStorage::reschedule(uint32_t nObjectId)
+{
+  leaveCellAt[nObjectId] = m_nNowUs;
+  schedule(nObjectId);
+}
+
+// Return the minimal 't >= 0', when 'p + v * t + a * t^2 / 2' is equal to
+// the specified 'bound', or infinity if it never happens
+static double timeToReach(double p, double v, double a, double bound)
+{
+  const double infinity = std::numeric_limits<double>::infinity();
+  const double d        = bound - p;
+  if (a == 0) {
+    return (v != 0 && d / v >= 0) ? d / v : infinity;
+  }
+  const double discriminant = v * v + 2 * a * d;
+  if (discriminant < 0) {
+    return infinity;
+  }
+  const double root = sqrt(discriminant);
+  const double t1   = (-v - root) / a;
+  const double t2   = (-v + root) / a;
+  const double tMin = std::min(t1, t2);
+  const double tMax = std::max(t1, t2);
+  return tMin >= 0 ? tMin : (tMax >= 0 ? tMax : infinity);
+}
+
+static double timeToLeave(double p, double v, double a,
+                          double nLowerBound, double nUpperBound)
+{
+  return std::min(timeToReach(p, v, a, nLowerBound),
+                  timeToReach(p, v, a, nUpperBound));
+}
+
+void PhysicsStorage::updateLeaveCellTime(uint32_t nObjectId)
+{
+  updateLeaveCellTime(nObjectId, cells[nObjectId]);
+}
+
+void PhysicsStorage::updateLeaveCellTime(uint32_t nObjectId,
+                                         world::Cell const* pCell)
+{
+  if (!pCell) {
+    // Object is out of the grid, so it should be checked on every tick
+    leaveCellAt[nObjectId] = m_nNowUs + 1;
+    return;
+  }
+
+  const geometry::Point  position = getPosition(nObjectId);
+  const geometry::Vector velocity = getVelocity(nObjectId);
+  const double ax = fx[nObjectId] * invMass[nObjectId];
+  const double ay = fy[nObjectId] * invMass[nObjectId];
+  const double nTimeSec = std::min(
+        timeToLeave(position.x, velocity.getX(), ax,
+                    pCell->left(), pCell->right()),
+        timeToLeave(position.y, velocity.getY(), ay,
+                    pCell->bottom(), pCell->top()));
+
+  // Objects with very low speed will not leave the cell in foreseeable future
+  const double nMaxTimeSec = static_cast<double>(eNever - m_nNowUs) / 1000000;
+  leaveCellAt[nObjectId] = nTimeSec < nMaxTimeSec
+      ? m_nNowUs + static_cast<uint64_t>(nTimeSec * 1000000) + 1
+      : eNever;
+}
+
+void PhysicsStorage::schedule(uint32_t nObjectId)
+{
+  const uint64_t nTimeUs = leaveCellAt[nObjectId];
+  if (nTimeUs != eNever) {
+    std::lock_guard<utils::Mutex> guard(m_crossingsMutex);
+    m_crossings.push(Crossing{nTimeUs, nObjectId});
+  }
+}
+
+void PhysicsStorage::updateMaxRadius(double radius)
+{
+  double nCurrent = m_nMaxRadius.load(std::memory_order_relaxed);
+  while (radius > nCurrent &&
+         !m_nMaxRadius.compare_exchange_weak(nCurrent, radius)) {}
+}
+
+void PhysicsStorage::popCrossings(std::vector<uint32_t>& objects)
+{
+  std::lock_guard<utils::Mutex> guard(m_crossingsMutex);
+  while (!m_crossings.empty() && m_crossings.top().nTimeUs <= m_nNowUs) {
+    const Crossing crossing = m_crossings.top();
+    m_crossings.pop();
+    const uint32_t nObjectId = crossing.nObjectId;
+    if (nObjectId < size() && alive[nObjectId]
+        && leaveCellAt[nObjectId] == crossing.nTimeUs) {
+      leaveCellAt[nObjectId] = eNever;
+      objects.push_back(nObjectId);
+    }
+  }
+}
+
+} // namespace newton
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <queue>
+#include <functional>
+#include <atomic>
+
+#include <Utils/Mutex.h>
+#include <Geometry/Point.h>
+#include <Geometry/Vector.h>
+#include <World/ObjectTypes.h>
+
+namespace world {
+class Cell;
+}
+
+namespace newton {
+
+// Dense (structure-of-arrays) storage for a physical state of all physical
+// objects. A state of a PhysicalObject is stored at the index, that is equal
+// to it's instance id, so NewtonEngine can proceed all objects in a contiguous
+// and branch-free loop, without touching PhysicalObject instances at all.
+// Slots, that are not used by any object, have zero velocity and zero force,
+// so they can be proceeded as well as used ones.
+//
+// Objects without external forces are moved "on rails": their position is
+// stored as (x, y) at moment 'railT0' and is evaluated on demand. Their
+// velocity is stored in 'railVx' and 'railVy', while 'vx' and 'vy' are zero,
+// so integration doesn't change their state.
+//
+// Since forces are constant between changes, the moment, when an object
+// leaves it's cell, can be calculated in advance (see 'leaveCellAt'). These
+// moments are stored in the crossings queue, so objects are re-tracked in
+// the grid only when they are about to cross a cell's border. The moment is
+// re-evaluated every time position, velocity, forces or weight of the object
+// are changed.
+//
+// Storage is NOT thread safe. As well as GlobalContainer, it may be read by
+// several threads, but it must not be resized (new physical object is
+// created) during reading.
+class PhysicsStorage
+{
+public:
+  static constexpr uint64_t eNever = UINT64_MAX;
+
+  static PhysicsStorage& instance();
+
+  void allocate(uint32_t nObjectId);
+    // Reset a state with the specified 'nObjectId'. Storage will grow, if
+    // it is required. Object is put on rails.
+  void release(uint32_t nObjectId);
+    // Reset a state with the specified 'nObjectId', so it won't be moved
+    // anymore.
+
+  uint32_t size() const { return static_cast<uint32_t>(x.size()); }
+
+  bool isOwnedBy(uint32_t nObjectId, uint32_t nPlayerId) const {
+    return nPlayerId && ownerId[nObjectId] == nPlayerId;
+  }
+    // Allows to check the owner of the object without touching the object
+    // itself (and locking it's owner's pointer)
+
+  world::ObjectType getType(uint32_t nObjectId) const {
+    return static_cast<world::ObjectType>(type[nObjectId]);
+  }
+  void setType(uint32_t nObjectId, world::ObjectType eType) {
+    type[nObjectId] = static_cast<uint8_t>(eType);
+  }
+
+  void     setNow(uint64_t nNowUs);
+  uint64_t now() const { return m_nNowUs; }
+    // In-game time, that corresponds to the current state of objects. If
+    // time goes back (the world has been restarted), on-rails objects are
+    // rebased to the new time.
+
+  geometry::Point  getPosition(uint32_t nObjectId) const;
+  geometry::Vector getVelocity(uint32_t nObjectId) const;
+  void moveTo(uint32_t nObjectId, geometry::Point const& position);
+  void setVelocity(uint32_t nObjectId, geometry::Vector const& velocity);
+
+  void putOnRails(uint32_t nObjectId);
+    // Object should have no external forces
+  void takeOffRails(uint32_t nObjectId);
+
+  void reschedule(uint32_t nObjectId);
+    // Request to re-track the specified object in the grid on the next tick.
+    // Should be called when an acceleration of the object has been changed.
+    // Thread safe.
+  void updateLeaveCellTime(uint32_t nObjectId);
+    // Calculate the time, when the object leaves it's current cell. Doesn't
+    // push it to the queue (see 'schedule()')
+  void updateLeaveCellTime(uint32_t nObjectId, world::Cell const* pCell);
+    // Calculate the time, when the object leaves the specified 'pCell'. Is
+    // used when object's new cell hasn't been stored in 'cells' yet.
+  void schedule(uint32_t nObjectId);
+    // Push the object's 'leaveCellAt' to the queue. Thread safe.
+  void popCrossings(std::vector<uint32_t>& objects);
+    // Append to the specified 'objects' all objects, that may have left
+    // their cells by now. Their 'leaveCellAt' is reset to 'eNever' until
+    // the new time is calculated.
+
+  void   updateMaxRadius(double radius);
+  double maxRadius() const { return m_nMaxRadius.load(std::memory_order_relaxed); }
+    // Radius of the largest object, that has ever existed. Since objects are
+    // stored in the grid by their centers, spatial queries should be
+    // extended by this value to find all objects, that touch the area.
+    // Thread safe.
+
+public:
+  // Position:
+  std::vector<double> x;
+  std::vector<double> y;
+  // Velocity:
+  std::vector<double> vx;
+  std::vector<double> vy;
+  // Sum of all external forces:
+  std::vector<double> fx;
+  std::vector<double> fy;
+  // 1 / weight:
+  std::vector<double> invMass;
+
+  // Cells, that contain objects. Is nullptr, if object hasn't been
+  // added to the grid yet
+  std::vector<world::Cell*> cells;
+  // Is set to 1, if the state is used by some object
+  std::vector<uint8_t>      alive;
+  // Id of the player, that owns the object (see world::Player::getPlayerId())
+  // or 0, if object has no owner
+  std::vector<uint32_t>     ownerId;
+  // Type of the object (world::ObjectType). Is set by constructors of derived
+  // classes and is passed to the grid, so cells can be filtered by type
+  std::vector<uint8_t>      type;
+
+  // On-rails objects only:
+  std::vector<uint8_t>  onRails;
+  std::vector<double>   railVx;
+  std::vector<double>   railVy;
+  std::vector<uint64_t> railT0;
+  std::vector<uint64_t> leaveCellAt;
+    // In-game time, when object should be re-tracked in the grid
+
+private:
+  double railTimeSec(uint32_t nObjectId) const {
+    return static_cast<double>(m_nNowUs - railT0[nObjectId]) / 1000000;
+  }
+
+private:
+  struct Crossing
+  {
+    uint64_t nTimeUs;
+    uint32_t nObjectId;
+    bool operator>(Crossing const& other) const {
+      return nTimeUs > other.nTimeUs;
+    }
+  };
+
+  utils::Mutex m_mutex;
+  uint64_t     m_nNowUs = 0;
+
+  std::atomic<double> m_nMaxRadius = 0;
+
+  utils::Mutex m_crossingsMutex;
+  std::priority_queue<Crossing, std::vector<Crossing>, std::greater<Crossing>>
+    m_crossings;
+    // Entries are never removed from the queue, when object's 'leaveCellAt'
+    // is changed; outdated entries are just skipped when they are popped
+};
+
+} // namespace newton
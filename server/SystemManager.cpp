@@ -106,6 +106,7 @@ void SystemManager::run(bool lColdStart)
   while (!m_clock.isTerminated()) {
     const uint32_t nIntervalUs = m_clock.getNextInterval();
     m_pConveyor->proceed(nIntervalUs);
+    m_pUdpDispatcher->flush();
     if (nIntervalUs < nMinTickLengthUs) {
       std::this_thread::yield();
     }
@@ -139,6 +140,7 @@ void SystemManager::run(bool lColdStart)
     m_barrier.wait();
     const uint32_t nIntervalUs = m_clock.getNextInterval();
     m_pConveyor->proceed(nIntervalUs);
+    m_pUdpDispatcher->flush();
     m_barrier.wait();
   }
 
@@ -155,11 +157,16 @@ void SystemManager::nextCycle()
 
 bool SystemManager::createAllComponents()
 {
-  m_pConveyor.reset(new conveyor::Conveyor(m_configuration.getTotalThreads()));
+  m_pConveyor.reset(new conveyor::Conveyor(
+        m_configuration.getTotalThreads(),
+        m_configuration.isWorkStealingConveyor()
+          ? conveyor::Conveyor::Mode::eWorkStealing
+          : conveyor::Conveyor::Mode::eLockstep));
 
   m_pSessionMuxManager        = std::make_shared<network::SessionMuxManager>();
   m_pNewtonEngine             = std::make_shared<newton::NewtonEngine>();
   m_pFilteringManager         = std::make_shared<tools::ObjectsFilteringManager>();
+  m_pSpatialQueryEngine       = std::make_shared<tools::SpatialQueryEngine>();
   m_pShipsManager             = std::make_shared<modules::ShipManager>();
   m_pCommutatorsManager       = std::make_shared<modules::CommutatorManager>();
   m_pEnginesManager           = std::make_shared<modules::EngineManager>();
@@ -176,7 +183,8 @@ bool SystemManager::createAllComponents()
   m_pUdpDispatcher = std::make_shared<network::UdpDispatcher>(
         m_IoService,
         m_configuration.getPortsPoolcfg().begin(),
-        m_configuration.getPortsPoolcfg().end());
+        m_configuration.getPortsPoolcfg().end(),
+        m_configuration.isNetworkIoThread());
   m_pLoginChannel = std::make_shared<network::PlayerChannel>();
   m_pAccessPanel  = std::make_shared<modules::AccessPanel>();
 
@@ -192,6 +200,7 @@ bool SystemManager::createAllComponents()
         m_configuration.getGlobalGridCfg().gridSize(),
         m_configuration.getGlobalGridCfg().cellWidthKm() * 1000);
   world::Grid::setGlobal(&m_globalGrid);
+  tools::SpatialQueryEngine::setGlobal(m_pSpatialQueryEngine.get());
 
   m_pPlayersStorage = std::make_shared<world::PlayersStorage>();
   return true;
@@ -221,6 +230,9 @@ bool SystemManager::linkComponents()
   m_pAccessPanel->attachToLoginSocket(m_pLoginSocket);
   m_pAccessPanel->attachToPlayerStorage(m_pPlayersStorage);
   m_pAccessPanel->attachToConnectionManager(m_pUdpDispatcher);
+  if (m_configuration.isMessagesCoalescing()) {
+    m_pAccessPanel->enableMessagesCoalescing();
+  }
 
   // Building the conveyor
   m_pConveyor->addLogicToChain(m_pNewtonEngine);
@@ -231,6 +243,7 @@ bool SystemManager::linkComponents()
   }
   m_pConveyor->addLogicToChain(m_pSessionMuxManager);
   m_pConveyor->addLogicToChain(m_pFilteringManager);
+  m_pConveyor->addLogicToChain(m_pSpatialQueryEngine);
   m_pConveyor->addLogicToChain(m_pCommutatorsManager);
   m_pConveyor->addLogicToChain(m_pSystemClockManager);
   m_pConveyor->addLogicToChain(m_pShipsManager);
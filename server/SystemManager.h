@@ -19,6 +19,7 @@
 #include <Modules/Fwd.h>
 #include <Arbitrators/BaseArbitrator.h>
 #include <ConveyorTools/ObjectsFilter.h>
+#include <ConveyorTools/SpatialQueryEngine.h>
 
 class SystemManager
 {
@@ -76,6 +77,7 @@ private:
   network::SessionMuxManagerPtr        m_pSessionMuxManager;
   newton::NewtonEnginePtr              m_pNewtonEngine;
   tools::ObjectsFilteringManagerPtr    m_pFilteringManager;
+  tools::SpatialQueryEnginePtr         m_pSpatialQueryEngine;
   modules::ShipManagerPtr              m_pShipsManager;
   modules::CommutatorManagerPtr        m_pCommutatorsManager;
   modules::EngineManagerPtr            m_pEnginesManager;
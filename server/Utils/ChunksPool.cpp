@@ -0,0 +1,157 @@
+#include "ChunksPool.h"
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+
+namespace utils {
+
+static size_t getThreadShardHint()
+{
+  static std::atomic_size_t gNextHint(0);
+  thread_local const size_t nHint = gNextHint.fetch_add(1);
+  return nHint;
+}
+
+ChunksPool::ChunksPool(size_t nSmallChunksCount,
+                       size_t nMediumChunksCount,
+                       size_t nHugeChunksCount,
+                       size_t nSmallChunksSize,
+                       size_t nMediumChunksSize,
+                       size_t nHugeChunksSize)
+  : ChunksPool({SizeClass{nSmallChunksSize,  nSmallChunksCount},
+                SizeClass{nMediumChunksSize, nMediumChunksCount},
+                SizeClass{nHugeChunksSize,   nHugeChunksCount}})
+{}
+
+ChunksPool::ChunksPool(std::vector<SizeClass> classes, size_t nShards)
+  : m_classes(std::move(classes)),
+    m_nHits(0), m_nFallbacks(0), m_nInUse(0), m_nHighWaterMark(0)
+{
+  if (!nShards) {
+    nShards = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, 8);
+  }
+  m_nShards = nShards;
+
+  std::sort(m_classes.begin(), m_classes.end(),
+            [](SizeClass const& left, SizeClass const& right) {
+              return left.nChunkSize < right.nChunkSize;
+            });
+  m_classOffsets.reserve(m_classes.size());
+  for (SizeClass& sizeClass: m_classes) {
+    // Chunks are split between shards, but at least one chunk of every class
+    // is given to every shard
+    sizeClass.nChunksCount = std::max<size_t>(
+          (sizeClass.nChunksCount + m_nShards - 1) / m_nShards, 1);
+    m_classOffsets.push_back(m_nShardArenaSize);
+    m_nShardArenaSize += sizeClass.nChunkSize * sizeClass.nChunksCount;
+  }
+  m_nArenaSize = m_nShardArenaSize * m_nShards;
+  m_pArena     = new uint8_t[m_nArenaSize];
+
+  m_pShards = std::make_unique<Shard[]>(m_nShards);
+  uint8_t* pChunk = m_pArena;
+  for (size_t nShardId = 0; nShardId < m_nShards; ++nShardId) {
+    Shard& shard = m_pShards[nShardId];
+    shard.m_freeChunks.resize(m_classes.size());
+    for (size_t nClassId = 0; nClassId < m_classes.size(); ++nClassId) {
+      SizeClass const&       sizeClass = m_classes[nClassId];
+      std::vector<uint8_t*>& chunks    = shard.m_freeChunks[nClassId];
+      chunks.reserve(sizeClass.nChunksCount);
+      for (size_t i = 0; i < sizeClass.nChunksCount; ++i) {
+        chunks.push_back(pChunk);
+        pChunk += sizeClass.nChunkSize;
+      }
+    }
+  }
+}
+
+ChunksPool::~ChunksPool()
+{
+  delete [] m_pArena;
+}
+
+uint8_t* ChunksPool::get(size_t nSize)
+{
+  size_t nFirstClass = 0;
+  while (nFirstClass < m_classes.size()
+         && m_classes[nFirstClass].nChunkSize < nSize) {
+    ++nFirstClass;
+  }
+
+  if (nFirstClass < m_classes.size()) {
+    const size_t nHomeShard = getThreadShardHint() % m_nShards;
+    for (size_t i = 0; i < m_nShards; ++i) {
+      uint8_t* pChunk = takeFromShard((nHomeShard + i) % m_nShards,
+                                      nFirstClass);
+      if (pChunk) {
+        m_nHits.fetch_add(1, std::memory_order_relaxed);
+        onTaken();
+        return pChunk;
+      }
+    }
+  }
+
+  m_nFallbacks.fetch_add(1, std::memory_order_relaxed);
+  onTaken();
+  return new uint8_t[nSize];
+}
+
+void ChunksPool::release(uint8_t* pChunk)
+{
+  m_nInUse.fetch_sub(1, std::memory_order_relaxed);
+
+  if (pChunk < m_pArena || pChunk >= m_pArena + m_nArenaSize) {
+    // Doesn't belong to pool
+    delete [] pChunk;
+    return;
+  }
+
+  const size_t nOffset  = static_cast<size_t>(pChunk - m_pArena);
+  const size_t nShardId = nOffset / m_nShardArenaSize;
+  const size_t nLocal   = nOffset % m_nShardArenaSize;
+  size_t nClassId = m_classes.size() - 1;
+  while (m_classOffsets[nClassId] > nLocal) {
+    --nClassId;
+  }
+
+  Shard& shard = m_pShards[nShardId];
+  std::lock_guard<Mutex> guard(shard.m_mutex);
+  shard.m_freeChunks[nClassId].push_back(pChunk);
+}
+
+ChunksPool::Stats ChunksPool::getStats() const
+{
+  Stats stats;
+  stats.nHits          = m_nHits.load(std::memory_order_relaxed);
+  stats.nFallbacks     = m_nFallbacks.load(std::memory_order_relaxed);
+  stats.nInUse         = m_nInUse.load(std::memory_order_relaxed);
+  stats.nHighWaterMark = m_nHighWaterMark.load(std::memory_order_relaxed);
+  return stats;
+}
+
+uint8_t* ChunksPool::takeFromShard(size_t nShardId, size_t nFirstClass)
+{
+  Shard& shard = m_pShards[nShardId];
+  std::lock_guard<Mutex> guard(shard.m_mutex);
+  for (size_t nClassId = nFirstClass; nClassId < m_classes.size(); ++nClassId) {
+    std::vector<uint8_t*>& chunks = shard.m_freeChunks[nClassId];
+    if (!chunks.empty()) {
+      uint8_t* pChunk = chunks.back();
+      chunks.pop_back();
+      return pChunk;
+    }
+  }
+  return nullptr;
+}
+
+void ChunksPool::onTaken()
+{
+  const size_t nInUse = m_nInUse.fetch_add(1, std::memory_order_relaxed) + 1;
+  size_t nHighWaterMark = m_nHighWaterMark.load(std::memory_order_relaxed);
+  while (nInUse > nHighWaterMark
+         && !m_nHighWaterMark.compare_exchange_weak(
+           nHighWaterMark, nInUse, std::memory_order_relaxed)) {}
+}
+
+} // namespace utils
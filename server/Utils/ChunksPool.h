@@ -1,99 +1,92 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <stdint.h>
 
+#include "Mutex.h"
+
 namespace utils {
 
+// Thread safe pool of memory chunks.
+// Chunks are grouped by size classes. Every class has a fixed number of
+// preallocated chunks, which are evenly split between shards. Every thread
+// takes chunks from "it's own" shard (threads are assigned to shards in a
+// round robin manner), so threads rarely compete for the same lock. If the
+// shard has no suitable chunks, other shards are checked and only then the
+// chunk is allocated on the heap.
+// Chunk can be released by any thread: it returns to the shard, it has been
+// taken from.
 class ChunksPool
 {
 public:
+  struct SizeClass {
+    size_t nChunkSize;
+    size_t nChunksCount;
+  };
+
+  struct Stats {
+    uint64_t nHits          = 0;
+      // How many times a chunk has been taken from the pool
+    uint64_t nFallbacks     = 0;
+      // How many times a chunk has been allocated on the heap
+    size_t   nInUse         = 0;
+      // How many chunks (including allocated on the heap) are in use now
+    size_t   nHighWaterMark = 0;
+      // The maximum of 'nInUse' ever
+  };
+
   ChunksPool(size_t nSmallChunksCount  = 128,
              size_t nMediumChunksCount = 64,
              size_t nHugeChunksCount   = 32,
              size_t nSmallChunksSize   = 256,
              size_t nMediumChunksSize  = 512,
-             size_t nHugeChunksSize    = 1024)
-    : m_nSmallChunksSize(nSmallChunksSize)
-    , m_nSmallChunksCount(nSmallChunksCount)
-    , m_nSmallArenaSize(nSmallChunksSize * nSmallChunksCount)
-    , m_nMediumChunksSize(nMediumChunksSize)
-    , m_nMediumChunksCount(nMediumChunksCount)
-    , m_nMediumArenaSize(nMediumChunksSize * nMediumChunksCount)
-    , m_nHugeChunksSize(nHugeChunksSize)
-    , m_nHugeChunksCount(nHugeChunksCount)
-    , m_nHugeArenaSize(nHugeChunksSize * nHugeChunksCount)
-  {
-    size_t nTotal = m_nSmallArenaSize + m_nMediumArenaSize + m_nHugeArenaSize;
-    m_pArena = new uint8_t[nTotal];
-
-    m_smallChunks.reserve(m_nSmallChunksCount);
-    m_mediumChunks.reserve(m_nMediumChunksCount);
-    m_hugeChunks.reserve(m_nHugeChunksCount);
-    uint8_t* pChunk = m_pArena;
-    for(size_t i = 0; i < m_nSmallChunksCount; ++i, pChunk += m_nSmallChunksSize)
-      m_smallChunks.push_back(pChunk);
-    for(size_t i = 0; i < m_nMediumChunksCount; ++i, pChunk += m_nMediumChunksSize)
-      m_mediumChunks.push_back(pChunk);
-    for(size_t i = 0; i < m_nHugeChunksCount; ++i, pChunk += m_nHugeChunksSize)
-      m_hugeChunks.push_back(pChunk);
-  }
+             size_t nHugeChunksSize    = 1024);
+  ChunksPool(std::vector<SizeClass> classes, size_t nShards = 0);
+    // If 'nShards' is 0, it is chosen according to the number of cores
 
   ChunksPool(ChunksPool const& other) = delete;
   ChunksPool(ChunksPool&& other)      = delete;
 
-  ~ChunksPool() { delete [] m_pArena; }
-
-  uint8_t* get(size_t nSize)
-  {
-    uint8_t* pChunk = nullptr;
-    if (nSize <= m_nSmallChunksSize && m_smallChunks.size()) {
-      pChunk = m_smallChunks.back();
-      m_smallChunks.pop_back();
-    } else if (nSize <= m_nMediumChunksSize && m_mediumChunks.size()) {
-      pChunk = m_mediumChunks.back();
-      m_mediumChunks.pop_back();
-    } else if (nSize <= m_nHugeChunksSize && m_hugeChunks.size()) {
-      pChunk = m_hugeChunks.back();
-      m_hugeChunks.pop_back();
-    } else {
-      pChunk = new uint8_t[nSize];
-    }
-    return pChunk;
-  }
-
-  void release(uint8_t* pChunk)
-  {
-    const size_t nOffset = (pChunk >= m_pArena) 
-      ? static_cast<size_t>(pChunk - m_pArena)
-      : std::numeric_limits<size_t>::max();
-    if (nOffset < m_nSmallArenaSize) {
-      m_smallChunks.push_back(pChunk);
-    } else if (nOffset < m_nSmallArenaSize + m_nMediumArenaSize) {
-      m_mediumChunks.push_back(pChunk);
-    } else if (nOffset < m_nSmallArenaSize + m_nMediumArenaSize + m_nHugeArenaSize) {
-      m_hugeChunks.push_back(pChunk);
-    } else {
-      // Doesn't belong to pool
-      delete [] pChunk;
-    }
-  }
+  ~ChunksPool();
+
+  uint8_t* get(size_t nSize);
+    // Return a chunk, that is at least 'nSize' bytes long. Thread safe.
+  void release(uint8_t* pChunk);
+    // Return the 'pChunk' back to pool. Thread safe.
+
+  size_t getShardsCount() const { return m_nShards; }
+  Stats  getStats() const;
 
 private:
-  std::vector<uint8_t*> m_smallChunks;
-  std::vector<uint8_t*> m_mediumChunks;
-  std::vector<uint8_t*> m_hugeChunks;
-
-  size_t m_nSmallChunksSize   = 0;
-  size_t m_nSmallChunksCount  = 0;
-  size_t m_nSmallArenaSize    = 0;
-  size_t m_nMediumChunksSize  = 0;
-  size_t m_nMediumChunksCount = 0;
-  size_t m_nMediumArenaSize   = 0;
-  size_t m_nHugeChunksSize    = 0;
-  size_t m_nHugeChunksCount   = 0;
-  size_t m_nHugeArenaSize     = 0;
-  uint8_t* m_pArena           = nullptr;
+  struct alignas(64) Shard {
+    Mutex m_mutex;
+    std::vector<std::vector<uint8_t*>> m_freeChunks;
+      // Free chunks of every size class
+  };
+
+  uint8_t* takeFromShard(size_t nShardId, size_t nFirstClass);
+    // Take a chunk of the smallest available class, starting from
+    // 'nFirstClass'; return nullptr if shard has no such chunks
+  void     onTaken();
+
+private:
+  std::vector<SizeClass> m_classes;
+    // Sorted by chunk size; 'nChunksCount' is a number of chunks per shard
+  std::vector<size_t>    m_classOffsets;
+    // Offset of every class's region inside the shard's region
+  size_t                 m_nShardArenaSize = 0;
+  size_t                 m_nArenaSize      = 0;
+  uint8_t*               m_pArena          = nullptr;
+
+  size_t                   m_nShards = 0;
+  std::unique_ptr<Shard[]> m_pShards;
+
+  std::atomic<uint64_t> m_nHits;
+  std::atomic<uint64_t> m_nFallbacks;
+  std::atomic<size_t>   m_nInUse;
+  std::atomic<size_t>   m_nHighWaterMark;
 };
 
 } // namespace utils
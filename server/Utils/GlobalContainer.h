@@ -193,6 +193,11 @@ public:
   virtual std::vector<ObjectType*> const& getObjects() const {
     return GlobalContainer<ObjectType>::AllInstancies();
   }
+
+  // Return true if the specified 'pObject' is in the container
+  virtual bool contains(ObjectType const* pObject) const {
+    return pObject != nullptr;
+  }
 };
 
 template<typename ObjectType>
@@ -246,6 +251,10 @@ public:
     return m_baseObjects;
   }
 
+  bool contains(BaseObjectType const* pObject) const override {
+    return dynamic_cast<ConcreteObjectType const*>(pObject) != nullptr;
+  }
+
 private:
   std::vector<BaseObjectType*> m_baseObjects;
 };
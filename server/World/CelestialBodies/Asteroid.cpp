@@ -8,6 +8,7 @@
 
 #include <Utils/YamlReader.h>
 #include <Utils/FloatComparator.h>
+#include <Newton/PhysicsStorage.h>
 
 DECLARE_GLOBAL_CONTAINER_CPP(world::Asteroid);
 
@@ -18,6 +19,8 @@ Asteroid::Asteroid(uint32_t seed)
   , m_randomizer(seed)
 {
   utils::GlobalObject<Asteroid>::registerSelf(this);
+  newton::PhysicsStorage::instance().setType(
+        newton::PhysicalObject::getInstanceId(), ObjectType::eAsteroid);
 }
 
 Asteroid::Asteroid(double radius,
@@ -28,6 +31,8 @@ Asteroid::Asteroid(double radius,
     m_randomizer(seed)
 {
   utils::GlobalObject<Asteroid>::registerSelf(this);
+  newton::PhysicsStorage::instance().setType(
+        newton::PhysicalObject::getInstanceId(), ObjectType::eAsteroid);
   m_composition.normalize();
   setWeight(calculateMass());
 }
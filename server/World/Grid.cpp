@@ -1,10 +1,17 @@
 #include "Grid.h"
 #include <assert.h>
+#include <algorithm>
 
 namespace world {
 
 Grid* Grid::g_globalGrid = nullptr;
 
+static int64_t floorDiv(int64_t a, int64_t b)
+{
+  const int64_t q = a / b;
+  return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
 
 Grid::Grid()
   : m_parentCell(nullptr, 0, 0, 0)
@@ -29,6 +36,11 @@ void Grid::build(uint16_t nWidth, uint32_t nCellWidth)
 
   m_parentCell = Cell(
         this, -nHalfSize, -nHalfSize, static_cast<uint32_t>(nLength));
+  m_outerIndex.clear();
+  m_outerCells.clear();
+  m_subCells.clear();
+  m_splitCells.clear();
+  m_overfilled.clear();
 
   m_cells.reserve(nWidth * nWidth);
   for (uint32_t i = 0; i < nWidth; ++i) {
@@ -40,32 +52,247 @@ void Grid::build(uint16_t nWidth, uint32_t nCellWidth)
   }
 }
 
+void Grid::move(uint32_t nObjectId, Cell* pFrom, Cell* pTo, ObjectType eType)
+{
+  if (pFrom) {
+    utils::UnorderedVector<uint32_t>& objects = pFrom->m_objectsIds;
+    std::vector<uint8_t>&             types   = pFrom->m_objectsTypes;
+    // Slot may be outdated, if object has been destroyed without being
+    // removed from the grid and it's id has been reused
+    uint32_t nSlot = nObjectId < m_slots.size() ? m_slots[nObjectId] : 0;
+    if (nSlot >= objects.size() || objects[nSlot] != nObjectId) {
+      nSlot = static_cast<uint32_t>(objects.find(nObjectId));
+    }
+    if (nSlot < objects.size()) {
+      if (eType == ObjectType::eUnknown) {
+        eType = static_cast<ObjectType>(types[nSlot]);
+      }
+      --pFrom->m_nObjectsOfType[types[nSlot]];
+      objects.remove(nSlot);
+      types[nSlot] = types.back();
+      types.pop_back();
+      if (nSlot < objects.size()) {
+        const uint32_t nMovedId = objects[nSlot];
+        if (nMovedId < m_slots.size()) {
+          m_slots[nMovedId] = nSlot;
+        }
+      }
+    }
+    assert(!objects.has(nObjectId));
+    assert(objects.size() == types.size());
+    ++pFrom->m_nVersion;
+  }
+
+  if (pTo) {
+    utils::UnorderedVector<uint32_t>& objects = pTo->m_objectsIds;
+    assert(!objects.has(nObjectId));
+    if (nObjectId >= m_slots.size()) {
+      m_slots.resize(nObjectId + 1, 0);
+    }
+    m_slots[nObjectId] = static_cast<uint32_t>(objects.size());
+    objects.push(nObjectId, false);
+    pTo->m_objectsTypes.push_back(static_cast<uint8_t>(eType));
+    ++pTo->m_nObjectsOfType[static_cast<size_t>(eType)];
+    ++pTo->m_nVersion;
+    if (m_nSplitThreshold && objects.size() > m_nSplitThreshold
+        && !pTo->m_lOverfilled && canSplit(*pTo)) {
+      pTo->m_lOverfilled = true;
+      m_overfilled.push_back(pTo);
+    }
+  }
+}
+
+bool Grid::canSplit(const Cell& cell) const
+{
+  // Children should cover the cell exactly
+  return cell.m_nDepth < eMaxSplitDepth
+      && cell.m_width >= 2 && cell.m_width % 2 == 0;
+}
+
+void Grid::split(Cell* pCell)
+{
+  assert(!pCell->m_pChildren);
+  const uint64_t nHalf = pCell->m_width / 2;
+  const int64_t  xMid  = pCell->m_x + static_cast<int64_t>(nHalf);
+  const int64_t  yMid  = pCell->m_y + static_cast<int64_t>(nHalf);
+  // Children are ordered as 'Cell::quadrantOf()' expects
+  m_subCells.push_back({Cell(this, pCell->m_x, pCell->m_y, nHalf),
+                        Cell(this, xMid,       pCell->m_y, nHalf),
+                        Cell(this, pCell->m_x, yMid,       nHalf),
+                        Cell(this, xMid,       yMid,       nHalf)});
+  for (Cell& child: m_subCells.back()) {
+    child.m_nDepth = pCell->m_nDepth + 1;
+  }
+  pCell->m_pChildren = m_subCells.back().data();
+  if (!pCell->m_nDepth) {
+    m_splitCells.push_back(pCell);
+  }
+}
+
+Grid::OuterKey Grid::outerKeyOf(int64_t x, int64_t y) const
+{
+  const int64_t nWidth = static_cast<int64_t>(m_parentCell.width());
+  return OuterKey{floorDiv(x - m_parentCell.left(), nWidth),
+                  floorDiv(y - m_parentCell.bottom(), nWidth)};
+}
+
+Cell* Grid::getOuterCell(int64_t x, int64_t y) const
+{
+  if (!m_parentCell.width()) {
+    return nullptr;
+  }
+  auto I = m_outerIndex.find(outerKeyOf(x, y));
+  return I != m_outerIndex.end() ? I->second : nullptr;
+}
+
+Cell* Grid::obtainOuterCell(int64_t x, int64_t y)
+{
+  if (!m_parentCell.width()) {
+    return nullptr;
+  }
+  const OuterKey key = outerKeyOf(x, y);
+  Cell*& pCell = m_outerIndex[key];
+  if (!pCell) {
+    const uint64_t nWidth = m_parentCell.width();
+    m_outerCells.emplace_back(
+          this,
+          m_parentCell.left()   + key.nColumn * static_cast<int64_t>(nWidth),
+          m_parentCell.bottom() + key.nRow * static_cast<int64_t>(nWidth),
+          nWidth);
+    pCell = &m_outerCells.back();
+  }
+  assert(pCell->contains(x, y));
+  return pCell;
+}
+
+void Grid::collectOuterCells(double x, double y, double x_end, double y_end,
+                             std::vector<const Cell*>& cells) const
+{
+  const double nLimit = static_cast<double>(eMaxCoordinate);
+  x     = std::clamp(x,     -nLimit, nLimit);
+  y     = std::clamp(y,     -nLimit, nLimit);
+  x_end = std::clamp(x_end, -nLimit, nLimit);
+  y_end = std::clamp(y_end, -nLimit, nLimit);
+  if (x >= x_end || y >= y_end) {
+    return;
+  }
+
+  auto hasIntersection = [x, y, x_end, y_end](const Cell& cell) {
+    return cell.left() < x_end && cell.right() > x
+        && cell.bottom() < y_end && cell.top() > y;
+  };
+
+  const OuterKey first = outerKeyOf(toInteger(x), toInteger(y));
+  const OuterKey last  = outerKeyOf(toInteger(x_end), toInteger(y_end));
+  const double nCandidates =
+      static_cast<double>(last.nColumn - first.nColumn + 1) *
+      static_cast<double>(last.nRow - first.nRow + 1);
+
+  if (nCandidates > static_cast<double>(m_outerIndex.size())) {
+    // It's cheaper to check all existing outer cells
+    for (const Cell& cell: m_outerCells) {
+      if (hasIntersection(cell)) {
+        cells.push_back(&cell);
+      }
+    }
+    return;
+  }
+
+  for (int64_t nRow = first.nRow; nRow <= last.nRow; ++nRow) {
+    for (int64_t nColumn = first.nColumn; nColumn <= last.nColumn; ++nColumn) {
+      auto I = m_outerIndex.find(OuterKey{nColumn, nRow});
+      if (I != m_outerIndex.end() && hasIntersection(*I->second)) {
+        cells.push_back(I->second);
+      }
+    }
+  }
+}
+
+void Grid::collectSubCells(double x, double y, double x_end, double y_end,
+                           std::vector<const Cell*>& cells) const
+{
+  auto hasIntersection = [x, y, x_end, y_end](const Cell& cell) {
+    return cell.left() < x_end && cell.right() > x
+        && cell.bottom() < y_end && cell.top() > y;
+  };
+
+  std::vector<const Cell*> stack;
+  for (const Cell* pCell: m_splitCells) {
+    if (hasIntersection(*pCell)) {
+      stack.push_back(pCell);
+    }
+  }
+  while (!stack.empty()) {
+    const Cell* pCell = stack.back();
+    stack.pop_back();
+    for (size_t i = 0; i < 4; ++i) {
+      const Cell& child = pCell->m_pChildren[i];
+      if (hasIntersection(child)) {
+        cells.push_back(&child);
+        if (child.m_pChildren) {
+          stack.push_back(&child);
+        }
+      }
+    }
+  }
+}
+
 Grid::iterator Grid::begin() const
 {
-  return iterator(this, 0, m_width, m_width);
+  std::vector<const Cell*> extraCells;
+  extraCells.reserve(m_outerCells.size() + 4 * m_subCells.size());
+  for (const Cell& cell: m_outerCells) {
+    extraCells.push_back(&cell);
+  }
+  for (const std::array<Cell, 4>& children: m_subCells) {
+    for (const Cell& cell: children) {
+      extraCells.push_back(&cell);
+    }
+  }
+  return iterator(this, 0, m_width, m_width, std::move(extraCells));
 }
 
 Grid::iterator Grid::end() const
 {
-  return iterator(this, m_cells.size(), 0, 0);
+  return iterator(this, 0, 0, 0);
 }
 
 Grid::iterator::iterator(
-    const Grid *pOwner,
-    size_t      nBegin,
-    size_t      nWidth,
-    size_t      nHeight)
-  : m_nRow(nBegin / pOwner->m_width),
-    m_nColumn(nBegin % pOwner->m_width),
+    const Grid*              pOwner,
+    size_t                   nBegin,
+    size_t                   nWidth,
+    size_t                   nHeight,
+    std::vector<const Cell*> extraCells)
+  : m_nRow(pOwner->m_width ? nBegin / pOwner->m_width : 0),
+    m_nColumn(pOwner->m_width ? nBegin % pOwner->m_width : 0),
     m_nPos(nBegin),
     m_nColumnLeft(m_nColumn),
     m_nColumnRight(m_nColumn + nWidth),
     m_nRowEnd(m_nRow + nHeight),
     m_nRowLength(pOwner->m_width),
+    m_extraCells(std::move(extraCells)),
     m_pOwner(pOwner)
-{}
+{
+  if (!nWidth || !nHeight || nBegin >= pOwner->m_cells.size()) {
+    skipToExtraCells();
+  }
+}
+
+void Grid::iterator::skipToExtraCells()
+{
+  m_nPos = m_extraCells.empty() ? npos : m_pOwner->m_cells.size();
+}
 
 Grid::iterator& Grid::iterator::operator++() {
+  if (m_nPos >= m_pOwner->m_cells.size()) {
+    // Iterating through outer cells and children of split cells
+    ++m_nPos;
+    if (m_nPos - m_pOwner->m_cells.size() >= m_extraCells.size()) {
+      m_nPos = npos;
+    }
+    return *this;
+  }
+
   ++m_nColumn;
   ++m_nPos;
   if (m_nColumn < m_nColumnRight) {
@@ -79,9 +306,9 @@ Grid::iterator& Grid::iterator::operator++() {
     return *this;
   }
   // End of area is reached
-  m_nPos    = m_pOwner->m_cells.size();
   m_nColumn = m_pOwner->m_width;
   m_nRow    = m_pOwner->m_width;
+  skipToExtraCells();
   return *this;
 }
 
@@ -1,84 +1,120 @@
 #pragma once
 
 #include <stdint.h>
+#include <array>
 #include <unordered_map>
 #include <memory>
 #include <vector>
+#include <deque>
+#include <cmath>
+#include <type_traits>
 #include <assert.h>
 
-#include <Utils/Mutex.h>
 #include <Utils/UnorderedVector.h>
 #include <Geometry/Rectangle.h>
+#include <World/ObjectTypes.h>
 
 namespace world {
 
 class Grid;
 
-
+// NOTE: cells have no synchronization. Any number of threads may read cells
+// and look for destination cells (see 'destination()') simultaneously, but
+// objects should be added and moved between cells by a single thread. It is
+// supposed, that threads, proceeding objects, collect their new cells and
+// then these changes are applied by a single thread (see NewtonEngine).
 class Cell
 {
+  friend class Grid;
 private:
   Grid     *m_pOwner;
-  int32_t   m_x;
-  int32_t   m_y;
-  uint32_t  m_width;
+  int64_t   m_x;
+  int64_t   m_y;
+  uint64_t  m_width;
 
-  utils::Mutex                     m_mutex;
   utils::UnorderedVector<uint32_t> m_objectsIds;
+  std::vector<uint8_t>             m_objectsTypes;
+    // Type of every object in 'm_objectsIds' (at the same index), so objects
+    // of some type can be found without touching objects themselves
+  uint32_t m_nObjectsOfType[static_cast<size_t>(ObjectType::eTotalObjectsTypes)] = {};
+  uint32_t m_nVersion = 0;
+
+  Cell*    m_pChildren   = nullptr;
+    // Quadrants of the cell, if it has been split (see 'Grid::split()')
+  uint8_t  m_nDepth      = 0;
+    // Number of splits, that produced this cell
+  bool     m_lOverfilled = false;
+    // Cell is waiting to be split (see 'Grid::splitOverfilledCells()')
+
+  template<typename NumericType>
+  size_t quadrantOf(NumericType x, NumericType y) const {
+    const int64_t nHalf = static_cast<int64_t>(m_width / 2);
+    return (x >= m_x + nHalf ? 1 : 0) + (y >= m_y + nHalf ? 2 : 0);
+  }
+    // Return index of the child, that covers the specified position
 
 public:
-  Cell(Grid* pOwner, int32_t x, int32_t y, uint32_t width)
+  Cell(Grid* pOwner, int64_t x, int64_t y, uint64_t width)
     : m_pOwner(pOwner),
       m_x(x),
       m_y(y),
       m_width(width)
   {}
 
-  Cell(const Cell& other)
-    : m_pOwner(other.m_pOwner),
-      m_x(other.m_x),
-      m_y(other.m_y),
-      m_width(other.m_width),
-      m_objectsIds(other.m_objectsIds)
-  {}
+  int64_t left()   const { return m_x; }
+  int64_t right()  const { return m_x + static_cast<int64_t>(m_width); }
+  int64_t bottom() const { return m_y; }
+  int64_t top()    const { return m_y + static_cast<int64_t>(m_width); }
+  uint64_t width() const { return m_width; }
 
-  world::Cell& operator=(world::Cell&& other) {
-    m_pOwner = std::move(other.m_pOwner);
-    m_x = std::move(other.m_x);
-    m_y = std::move(other.m_y);
-    m_width = std::move(other.m_width);
-    m_objectsIds = std::move(other.m_objectsIds);
-    return *this;
-  }
-  int32_t left()   const { return m_x; }
-  int32_t right()  const { return m_x + static_cast<int32_t>(m_width); }
-  int32_t bottom() const { return m_y; }
-  int32_t top()    const { return m_y + static_cast<int32_t>(m_width); }
+  bool    isSplit() const { return m_pChildren != nullptr; }
+    // Split cell has no objects: they are stored in it's children
+  uint8_t depth()   const { return m_nDepth; }
 
   template<typename NumericType>
   bool contains(NumericType x, NumericType y) const {
-    return (x >= m_x) && static_cast<uint64_t>(x - m_x) < m_width
-        && (y >= m_y) && static_cast<uint64_t>(y - m_y) < m_width;
+    return x >= m_x && x < right() && y >= m_y && y < top();
   }
 
   template<typename NumericType>
   void add(
     uint32_t nObjectId,
     [[maybe_unused]] NumericType x,
-    [[maybe_unused]] NumericType y)
-  {
-    std::lock_guard<utils::Mutex> guard(m_mutex);
-    assert(contains(x, y));
-    assert(!m_objectsIds.has(nObjectId));
-    m_objectsIds.push(nObjectId);
-  }
+    [[maybe_unused]] NumericType y,
+    ObjectType eType = ObjectType::eUnknown);
 
   const utils::UnorderedVector<uint32_t>& getObjects() const {
     return m_objectsIds;
   }
 
+  ObjectType getObjectType(size_t nIndex) const {
+    return static_cast<ObjectType>(m_objectsTypes[nIndex]);
+  }
+    // Return type of the object, that is stored at the specified 'nIndex' in
+    // 'getObjects()'
+
+  uint32_t countObjects(ObjectType eType) const {
+    return m_nObjectsOfType[static_cast<size_t>(eType)];
+  }
+    // Return number of objects of the specified 'eType' in the cell, so
+    // type-filtered queries may skip the whole cell
+
+  uint32_t getVersion() const { return m_nVersion; }
+    // Is incremented every time an object enters or leaves the cell, so a
+    // reader may check if the cell's objects have been changed since the
+    // last time it has looked at them
+
+  template<typename NumericType>
+  Cell* destination(NumericType x, NumericType y) const;
+    // Return a cell, that contains the specified 'x' and 'y' position. If
+    // there is no such cell yet (see 'Grid::obtainCell()'), return nullptr.
+    // Is thread safe.
+
   template<typename NumericType>
   Cell* track(uint32_t nObjectId, NumericType x, NumericType y);
+    // Move the object with the specified 'nObjectId' to the cell, that
+    // contains the specified 'x' and 'y' position and return that cell.
+    // Return nullptr if position is out of the grid's bounds.
 
   geometry::Rectangle asRect() const {
     return geometry::Rectangle(
@@ -87,12 +123,68 @@ public:
   }
 };
 
+// Grid has two levels:
+// 1. the dense level ("core"): 'nWidth' x 'nWidth' cells, 'nCellWidth' each,
+//    that are centered at (0, 0). This level is supposed to cover the area,
+//    where most of objects are located;
+// 2. the sparse outer level: cells of the same size as the whole core, that
+//    cover the rest of the space. These cells are created on demand, when
+//    the first object gets into them, so the deep space doesn't consume any
+//    memory, until some objects are there.
+// So, the grid covers any position, which coordinates are less than
+// 'eMaxCoordinate' by absolute value.
+// A cell of any level, that has got more than 'splitThreshold' objects, may
+// be split into four quadrants (recursively, up to 'eMaxSplitDepth' times),
+// so a dense cluster of objects (e.g. an asteroid field) is covered by
+// smaller cells, while the rest of the grid stays coarse. Objects of the
+// split cell are moved to it's children, but the cell itself is kept, so
+// cells never disappear.
 class Grid {
+  friend class Cell;
+
+public:
+  static constexpr int64_t eMaxCoordinate = int64_t(1) << 52;
+    // Doubles represent all integers up to this value exactly
+  static constexpr uint32_t eDefaultSplitThreshold = 128;
+  static constexpr uint8_t  eMaxSplitDepth         = 4;
+
+private:
+  struct OuterKey {
+    int64_t nColumn;
+    int64_t nRow;
+    bool operator==(const OuterKey& other) const {
+      return nColumn == other.nColumn && nRow == other.nRow;
+    }
+  };
+
+  struct OuterKeyHash {
+    size_t operator()(const OuterKey& key) const {
+      return std::hash<int64_t>()(key.nColumn * 0x9E3779B97F4A7C15ULL
+                                  ^ key.nRow);
+    }
+  };
+
   uint32_t          m_cellWidth = 0;
   uint16_t          m_width     = 0;
   std::vector<Cell> m_cells;
   Cell              m_parentCell;
 
+  std::deque<Cell>  m_outerCells;
+    // Deque is used, since cells must not be moved in memory
+  std::unordered_map<OuterKey, Cell*, OuterKeyHash> m_outerIndex;
+
+  std::vector<uint32_t> m_slots;
+    // Index of every object in it's cell's objects list, so that object
+    // can be removed from the cell in O(1)
+
+  uint32_t                        m_nSplitThreshold = eDefaultSplitThreshold;
+  std::deque<std::array<Cell, 4>> m_subCells;
+    // Children of all split cells
+  std::vector<Cell*>              m_splitCells;
+    // Cells of the core and outer cells, that have been split
+  std::vector<Cell*>              m_overfilled;
+    // Cells, that should be split by the next 'splitOverfilledCells()' call
+
   template<typename NumericType>
   size_t indexOf(NumericType x, NumericType y) const {
     const int32_t i = (x - m_parentCell.left()) / m_cellWidth;
@@ -102,6 +194,48 @@ class Grid {
     return index;
   }
 
+  template<typename NumericType>
+  static int64_t toInteger(NumericType value) {
+    if constexpr (std::is_floating_point_v<NumericType>) {
+      return static_cast<int64_t>(std::floor(value));
+    } else {
+      return static_cast<int64_t>(value);
+    }
+  }
+
+  template<typename NumericType>
+  static bool inBounds(NumericType x, NumericType y) {
+    return x > -eMaxCoordinate && x < eMaxCoordinate
+        && y > -eMaxCoordinate && y < eMaxCoordinate;
+  }
+
+  template<typename NumericType>
+  static Cell* leafOf(Cell* pCell, NumericType x, NumericType y) {
+    while (pCell->m_pChildren) {
+      pCell = &pCell->m_pChildren[pCell->quadrantOf(x, y)];
+    }
+    return pCell;
+  }
+    // Return a child of the specified 'pCell' (or the cell itself), that
+    // contains the specified position and has not been split
+
+  bool canSplit(const Cell& cell) const;
+  void split(Cell* pCell);
+    // Create children of the specified 'pCell' (objects are not moved)
+
+  OuterKey outerKeyOf(int64_t x, int64_t y) const;
+  Cell*    getOuterCell(int64_t x, int64_t y) const;
+  Cell*    obtainOuterCell(int64_t x, int64_t y);
+
+  void collectOuterCells(double x, double y, double x_end, double y_end,
+                         std::vector<const Cell*>& cells) const;
+    // Append to the specified 'cells' all outer cells, that have
+    // intersection with the specified rectangle
+  void collectSubCells(double x, double y, double x_end, double y_end,
+                       std::vector<const Cell*>& cells) const;
+    // Append to the specified 'cells' all children of split cells, that have
+    // intersection with the specified rectangle
+
   static Grid* g_globalGrid;
 
 public:
@@ -111,15 +245,21 @@ public:
     using pointer           = const value_type*;
     using reference         = const value_type&;
 
-    iterator(const Grid* pOwner,
-             size_t      nBegin,
-             size_t      nWidth,
-             size_t      nHeight);
+    iterator(const Grid*              pOwner,
+             size_t                   nBegin,
+             size_t                   nWidth,
+             size_t                   nHeight,
+             std::vector<const Cell*> extraCells = {});
     // Create an iterator that starts from the cell with the specified 'nBegin'
     // index and iterate throught the region of the specified 'nWidth' columns
-    // and 'nHieght' rows.
+    // and 'nHieght' rows of the core. Then iterator goes through the
+    // specified 'extraCells' (outer cells and children of split cells).
 
   private:
+    static constexpr size_t npos = SIZE_MAX;
+
+    void skipToExtraCells();
+
     // Current position
     size_t m_nRow;
     size_t m_nColumn;
@@ -129,17 +269,21 @@ public:
     size_t m_nColumnRight;
     size_t m_nRowEnd;
     size_t m_nRowLength;
+    // Outer cells and children of split cells (positions after the core
+    // cells)
+    std::vector<const Cell*> m_extraCells;
     // Owner
     const Grid* m_pOwner;
 
   public:
-    reference operator*()  const {
-      assert(m_nPos < m_pOwner->m_cells.size());
-      return m_pOwner->m_cells[m_nPos];
-    }
+    reference operator*()  const { return *operator->(); }
     pointer operator->()  const {
-      assert(m_nPos < m_pOwner->m_cells.size());
-      return &m_pOwner->m_cells[m_nPos];
+      const size_t nCoreSize = m_pOwner->m_cells.size();
+      if (m_nPos < nCoreSize) {
+        return &m_pOwner->m_cells[m_nPos];
+      }
+      assert(m_nPos - nCoreSize < m_extraCells.size());
+      return m_extraCells[m_nPos - nCoreSize];
     }
 
     iterator& operator++();
@@ -172,46 +316,100 @@ public:
   void build(uint16_t nWidth, uint32_t nCellWidth);
     // Rebuild the grid.
 
-  int32_t left()   const { return m_parentCell.left(); }
-  int32_t right()  const { return m_parentCell.right(); }
-  int32_t bottom() const { return m_parentCell.bottom(); }
-  int32_t top()    const { return m_parentCell.top(); }
+  void setSplitThreshold(uint32_t nThreshold) { m_nSplitThreshold = nThreshold; }
+  uint32_t splitThreshold() const { return m_nSplitThreshold; }
+    // Cell, that has more objects, is split by 'splitOverfilledCells()'. If
+    // threshold is 0, cells are never split.
+
+  int64_t left()   const { return m_parentCell.left(); }
+  int64_t right()  const { return m_parentCell.right(); }
+  int64_t bottom() const { return m_parentCell.bottom(); }
+  int64_t top()    const { return m_parentCell.top(); }
 
   template<typename NumericType>
   const Cell* getCell(NumericType x, NumericType y) const {
-    return contains(x, y) ? &m_cells[indexOf(x, y)] : nullptr;
+    return const_cast<Grid*>(this)->getCell(x, y);
   }
 
   template<typename NumericType>
   Cell* getCell(NumericType x, NumericType y) {
-    return contains(x, y) ? &m_cells[indexOf(x, y)] : nullptr;
+    if (contains(x, y)) {
+      return leafOf(&m_cells[indexOf(x, y)], x, y);
+    }
+    if (m_outerCells.empty() || !inBounds(x, y)) {
+      return nullptr;
+    }
+    Cell* pCell = getOuterCell(toInteger(x), toInteger(y));
+    return pCell ? leafOf(pCell, x, y) : nullptr;
   }
+    // Return a cell, that contains the specified 'x' and 'y' position or
+    // nullptr, if there is no such cell. Returned cell is never split. Is
+    // thread safe.
 
   template<typename NumericType>
-  Cell* add(uint32_t nObjectId, NumericType x, NumericType y) {
-    Cell* pCell = getCell(x, y);
+  Cell* obtainCell(NumericType x, NumericType y) {
+    if (contains(x, y)) {
+      return leafOf(&m_cells[indexOf(x, y)], x, y);
+    }
+    if (!inBounds(x, y)) {
+      return nullptr;
+    }
+    return leafOf(obtainOuterCell(toInteger(x), toInteger(y)), x, y);
+  }
+    // Return a cell, that contains the specified 'x' and 'y' position. If
+    // it is an outer cell, that doesn't exist yet, create it. Return nullptr
+    // only if the position is out of the grid's bounds. Is NOT thread safe.
+
+  template<typename NumericType>
+  Cell* add(uint32_t nObjectId, NumericType x, NumericType y,
+            ObjectType eType = ObjectType::eUnknown) {
+    Cell* pCell = obtainCell(x, y);
     if (pCell) {
-      pCell->add(nObjectId, x, y);
+      pCell->add(nObjectId, x, y, eType);
     }
     return pCell;
   }
 
+  void move(uint32_t nObjectId, Cell* pFrom, Cell* pTo,
+            ObjectType eType = ObjectType::eUnknown);
+    // Move the object with the specified 'nObjectId' from the specified
+    // 'pFrom' cell to the specified 'pTo' cell. Any of cells may be nullptr.
+    // Object gets the specified 'eType' tag in the 'pTo' cell. If 'eType' is
+    // 'eUnknown', the object keeps the tag, it had in the 'pFrom' cell.
+    // Complexity: O(1)
+
+  template<typename PositionOf, typename OnRelocated>
+  size_t splitOverfilledCells(PositionOf&& fPositionOf,
+                              OnRelocated&& fOnRelocated);
+    // Split all cells, that have got more than 'splitThreshold()' objects,
+    // and move their objects to the children. Since the grid doesn't know
+    // positions of objects, 'fPositionOf(nObjectId)' should return the
+    // object's position. Every moved object is reported by the
+    // 'fOnRelocated(nObjectId, pNewCell)' call. Return number of split
+    // cells. Is NOT thread safe.
+
   const std::vector<Cell>& cells() const { return m_cells; }
+    // Cells of the core
+  const std::deque<Cell>& outerCells() const { return m_outerCells; }
 
   template<typename NumericType>
   bool contains(NumericType x, NumericType y) const {
     return m_parentCell.contains(x, y);
   }
+    // Return true if the specified position is covered by the core
 
   iterator begin() const;
   iterator end() const;
+    // Iterate through all cells: the core's cells, outer cells and then
+    // children of split cells
 
   template<typename NumericType>
   iterator range(NumericType x, NumericType y,
                  NumericType width, NumericType height) const;
-  // Return iterator, that iterates through all cells, covered by a rectangle
-  // of size 'width' and 'height' with it's top left cornet at the specified
-  // 'x' and 'y' position.
+  // Return iterator, that iterates through all cells (including outer cells
+  // and children of split cells), covered by a rectangle of size 'width' and
+  // 'height' with it's top left cornet at the specified 'x' and 'y' position.
+  // Split cells are returned as well, but they have no objects.
 
   geometry::Rectangle asRect() const {
     return m_parentCell.asRect();
@@ -219,23 +417,35 @@ public:
 };
 
 
+template<typename NumericType>
+inline void Cell::add(
+    uint32_t nObjectId,
+    [[maybe_unused]] NumericType x,
+    [[maybe_unused]] NumericType y,
+    ObjectType eType)
+{
+  assert(contains(x, y));
+  assert(!isSplit());
+  m_pOwner->move(nObjectId, nullptr, this, eType);
+}
+
+template<typename NumericType>
+inline Cell* Cell::destination(NumericType x, NumericType y) const {
+  if (!m_pChildren && contains(x, y)) {
+    return const_cast<Cell*>(this);
+  }
+  return m_pOwner->getCell(x, y);
+}
+
 template<typename NumericType>
 inline Cell *Cell::track(uint32_t nObjectId, NumericType x, NumericType y) {
-  if (contains(x, y)) {
-    return this;
+  Cell* pNewCell = destination(x, y);
+  if (!pNewCell) {
+    pNewCell = m_pOwner->obtainCell(x, y);
   }
-  // This is unlikely path, so we can afford to lock mutex here
-  Cell *pNewCell = m_pOwner->getCell(x, y);
-  if (pNewCell) {
-    assert(pNewCell->contains(x, y));
-    std::lock_guard guard(pNewCell->m_mutex);
-    assert(!pNewCell->m_objectsIds.has(nObjectId));
-    pNewCell->m_objectsIds.push(nObjectId, false);
+  if (pNewCell != this) {
+    m_pOwner->move(nObjectId, this, pNewCell);
   }
-
-  std::lock_guard guard(m_mutex);
-  m_objectsIds.removeFirst(nObjectId);
-  assert(!m_objectsIds.has(nObjectId));
   return pNewCell;
 }
 
@@ -249,16 +459,24 @@ Grid::iterator Grid::range(NumericType x, NumericType y,
   NumericType x_end = x + width;
   NumericType y_end = y + height;
 
+  std::vector<const Cell*> extraCells;
+  if (!m_outerCells.empty()) {
+    collectOuterCells(x, y, x_end, y_end, extraCells);
+  }
+  if (!m_splitCells.empty()) {
+    collectSubCells(x, y, x_end, y_end, extraCells);
+  }
+
   // Check if parent cell and user's rect has any intersections
   if (x >= m_parentCell.right() || x_end <= m_parentCell.left() ||
       y >= m_parentCell.top() || y_end <= m_parentCell.bottom()) {
-    return end();
+    return iterator(this, 0, 0, 0, std::move(extraCells));
   }
 
   x = std::max(x, static_cast<NumericType>(m_parentCell.left()));
   y = std::max(y, static_cast<NumericType>(m_parentCell.bottom()));
   if (!m_parentCell.contains(x, y)) {
-    return end();
+    return iterator(this, 0, 0, 0, std::move(extraCells));
   }
 
   x_end = std::min(x_end, static_cast<NumericType>(m_parentCell.right() - 1));
@@ -275,7 +493,39 @@ Grid::iterator Grid::range(NumericType x, NumericType y,
   const size_t regionWidth  = nEnd % m_width - nBegin % m_width + 1;
   const size_t regionHeight = nEnd / m_width - nBegin / m_width + 1;
 
-  return iterator(this, nBegin, regionWidth, regionHeight);
+  return iterator(
+        this, nBegin, regionWidth, regionHeight, std::move(extraCells));
+}
+
+template<typename PositionOf, typename OnRelocated>
+size_t Grid::splitOverfilledCells(PositionOf&& fPositionOf,
+                                  OnRelocated&& fOnRelocated)
+{
+  size_t nTotalSplit = 0;
+  // Children may get overfilled as well, so they are appended to the
+  // 'm_overfilled' during the loop
+  for (size_t i = 0; i < m_overfilled.size(); ++i) {
+    Cell* pCell = m_overfilled[i];
+    pCell->m_lOverfilled = false;
+    if (pCell->m_pChildren || !m_nSplitThreshold
+        || pCell->m_objectsIds.size() <= m_nSplitThreshold) {
+      continue;
+    }
+    split(pCell);
+    ++nTotalSplit;
+    utils::UnorderedVector<uint32_t>& objects = pCell->m_objectsIds;
+    while (objects.size()) {
+      // Removing the last object doesn't reorder the rest of them
+      const uint32_t        nObjectId = objects[objects.size() - 1];
+      const geometry::Point position  = fPositionOf(nObjectId);
+      Cell* pChild = &pCell->m_pChildren[pCell->quadrantOf(position.x,
+                                                           position.y)];
+      move(nObjectId, pCell, pChild);
+      fOnRelocated(nObjectId, pChild);
+    }
+  }
+  m_overfilled.clear();
+  return nTotalSplit;
 }
 
 }  // namespace world
@@ -4,6 +4,8 @@
 #include <Utils/StringUtils.h>
 #include <yaml-cpp/yaml.h>
 
+#include <atomic>
+
 #include <Modules/BlueprintsStorage/BlueprintsStorage.h>
 #include <Modules/Commutator/Commutator.h>
 #include <Modules/Messanger/Messanger.h>
@@ -19,6 +21,8 @@
 namespace world
 {
 
+static std::atomic_uint32_t gNextPlayerId(1);
+
 class RootSession : public network::IPlayerTerminal  {
 private:
   network::SessionMuxWeakPtr m_pSessionMuxWeakPtr;
@@ -84,7 +88,8 @@ private:
 
 Player::Player(std::string&& sLogin,
                blueprints::BlueprintsLibrary&& blueprints)
-  : m_sLogin(std::move(sLogin)),
+  : m_nPlayerId(gNextPlayerId.fetch_add(1)),
+    m_sLogin(std::move(sLogin)),
     m_pSessionMux(std::make_shared<network::SessionMux>()),
     m_pRootCommutator(std::make_shared<modules::Commutator>(m_pSessionMux)),
     m_pRootSession(std::make_shared<RootSession>(m_pSessionMux, m_pRootCommutator)),
@@ -183,6 +188,10 @@ void Player::attachToUdpSocket(network::UdpSocketPtr pSocket)
     m_pProtobufChannel = std::make_shared<network::PlayerChannel>();
     m_linker.link(m_pProtobufChannel, m_pSessionMux->asTerminal());
   }
+  if (pSocket->isCoalescing()) {
+    // Coalesced messages should be framed, so that client could split them
+    m_pProtobufChannel->enableBatching();
+  }
   m_linker.link(m_pUdpChannel, m_pProtobufChannel);
   // Add a custom unlinker logic, that closes all active connections, otherwise
   // SessionMux will raise an assert error in it's descructor
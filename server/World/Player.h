@@ -42,6 +42,10 @@ public:
   // Register a new connection and return a root sessionId
   uint32_t onNewConnection(uint32_t nConnectionId);
 
+  uint32_t getPlayerId() const { return m_nPlayerId; }
+    // Unique (non zero) id of the player; is used instead of comparing
+    // pointers, when the owner of some object should be checked
+
   std::string const& getLogin()    const { return m_sLogin; }
   std::string const& getPassword() const { return m_sPassword; }
 
@@ -58,6 +62,7 @@ private:
   void open_commutator_session(uint32_t nSessionId);
 
 private:
+  uint32_t     m_nPlayerId;
   std::string  m_sLogin;
   std::string  m_sPassword;
 